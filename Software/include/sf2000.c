@@ -0,0 +1,49 @@
+/*
+ * SF2000 helpers shared by the Software/ tools, declared in sf2000.h.
+ * Built by the Makefiles of the tools that use them.
+ */
+
+#include <exec/execbase.h>
+#include <exec/memory.h>
+#include <proto/exec.h>
+#include <proto/expansion.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "sf2000.h"
+
+extern struct ExecBase *SysBase;
+
+/** findFlashWindow
+ *
+ * @brief Find a 1MB address range for the flash window that no memory or expansion board uses
+ * SF2000_FLASH_WINDOW is preferred, then the ranges below it down to SF2000_FLASH_WINDOW_MIN.
+ * expansion.library must be open.
+ * @returns Base address of the range or 0 if there is none
+*/
+ULONG findFlashWindow() {
+  ULONG found = 0;
+
+  Forbid();
+
+  for (ULONG base = SF2000_FLASH_WINDOW; base >= SF2000_FLASH_WINDOW_MIN && found == 0; base -= SF2000_FLASH_WINDOW_SIZE) {
+    bool used = false;
+    struct ConfigDev *cd = NULL;
+    struct MemHeader *mh;
+
+    while ((cd = (struct ConfigDev*)FindConfigDev(cd,-1,-1)) != NULL) {
+      ULONG board = (ULONG)cd->cd_BoardAddr;
+      if (board < base + SF2000_FLASH_WINDOW_SIZE && board + cd->cd_BoardSize > base) used = true;
+    }
+
+    for (mh = (struct MemHeader *)SysBase->MemList.lh_Head; mh->mh_Node.ln_Succ; mh = (struct MemHeader *)mh->mh_Node.ln_Succ) {
+      if ((ULONG)mh->mh_Lower < base + SF2000_FLASH_WINDOW_SIZE && (ULONG)mh->mh_Upper > base) used = true;
+    }
+
+    if (!used) found = base;
+  }
+
+  Permit();
+
+  return found;
+}
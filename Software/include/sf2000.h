@@ -0,0 +1,123 @@
+/*
+ * SF2000 control board register map, shared by the Software/ tools.
+ * Must be kept in sync with rtl/main_top.v and the register blocks it decodes.
+ */
+
+#ifndef SF2000_H
+#define SF2000_H
+
+#include <exec/types.h>
+
+#define SF2000_MANUF_ID      5194
+#define SF2000_RAM_PROD_ID   10
+#define SF2000_SD_PROD_ID    11
+#define SF2000_CTRL_PROD_ID  12
+
+// Register blocks in the 64KB control board
+#define SF2000_CONTROL       0x0000
+#define SF2000_PERFMON       0x1000
+#define SF2000_BUSTRACE      0x2000
+#define SF2000_WAITSTATES    0x3000
+
+// Board control, relative to SF2000_CONTROL
+#define CTRL_ID              0x00
+#define CTRL_REVISION        0x02
+#define CTRL_STATUS          0x04
+#define CTRL_CONTROL         0x06
+#define CTRL_FLASH_BASE      0x08
+
+#define CTRL_BOARD_ID        0x5346
+
+#define CTRL_STAT_CLKSEL(s)  ((s) & 7)
+#define CTRL_STAT_TURBO      (1 << 3)
+#define CTRL_STAT_MAPROM     (1 << 4)
+#define CTRL_STAT_FLASH_BUSY (1 << 5)
+#define CTRL_STAT_JP(s,n)    (((s) >> ((n) + 2)) & 1)  // JP6-JP9, 1 when open
+
+#define CTRL_FLASH_ENABLE    (1 << 0)
+#define CTRL_MAPROM_OFF      (1 << 1)
+#define CTRL_CLK_OVERRIDE    (1 << 2)
+#define CTRL_CLK_SETTING(n)  (((n) & 7) << 4)
+
+// Flash window base for CTRL_FLASH_BASE, 1MB aligned, $200000-$A00000
+#define CTRL_FLASH_BASE_ADDR(reg) ((ULONG)((reg) & 0xF0) << 16)
+#define CTRL_FLASH_BASE_REG(addr) ((UWORD)(((addr) >> 16) & 0xF0))
+
+#define SF2000_FLASH_WINDOW      0xA00000  // Preferred window, and the fixed one of bitstreams without the control board
+#define SF2000_FLASH_WINDOW_MIN  0x200000  // Lowest window, chip RAM is below
+#define SF2000_FLASH_WINDOW_SIZE 0x100000
+
+// Performance counters, 32 bit, relative to SF2000_PERFMON
+#define PERF_CTRL            0x00
+#define PERF_CLOCKS          0x20
+#define PERF_MB_STALL        0x24
+#define PERF_SD_BYTES        0x28
+#define PERF_SD_UNDERRUN     0x2C
+#define PERF_BUS_CYCLES(n)   (0x40 + ((n) << 2))
+#define PERF_WAIT_CYCLES(n)  (0x60 + ((n) << 2))
+
+#define PERF_CTRL_FREEZE     (1 << 0)
+#define PERF_CTRL_CLEAR      (1 << 1)
+
+#define REGION_MB            0
+#define REGION_FASTRAM       1
+#define REGION_FLASH         2
+#define REGION_IDE           3
+#define REGION_SD            4
+#define REGION_CTRL          5
+#define REGIONS              6
+
+// Bus trace, relative to SF2000_BUSTRACE
+#define TRACE_CTRL           0x00
+#define TRACE_POST           0x02
+#define TRACE_WR_PTR         0x04
+#define TRACE_TRIG_PTR       0x06
+#define TRACE_DEPTH          0x08
+#define TRACE_TRIG_TYPE      0x0A
+#define TRACE_TRIG_FC        0x0C
+#define TRACE_TRIG_LO        0x10
+#define TRACE_TRIG_HI        0x14
+#define TRACE_RD_PTR         0x18
+#define TRACE_DATA           0x20
+
+#define TRACE_CTRL_ARM       (1 << 0)
+#define TRACE_CTRL_FORCE     (1 << 1)
+#define TRACE_CTRL_STOP      (1 << 2)
+
+#define TRACE_STAT_RUNNING   (1 << 0)
+#define TRACE_STAT_TRIGGERED (1 << 1)
+#define TRACE_STAT_WRAPPED   (1 << 2)
+
+#define TRACE_TYPE_READ      (1 << 0)
+#define TRACE_TYPE_WRITE     (1 << 1)
+
+// Fields of a trace entry, read as two longwords
+#define TRACE_TIME(hi)       ((hi) >> 8)
+#define TRACE_WAIT(hi)       ((hi) & 0xFF)
+#define TRACE_REGION(lo)     (((lo) >> 29) & 7)
+#define TRACE_FC(lo)         (((lo) >> 26) & 7)
+#define TRACE_READ(lo)       (((lo) >> 25) & 1)
+#define TRACE_UDS(lo)        (((lo) >> 24) & 1)
+#define TRACE_LDS(lo)        (((lo) >> 23) & 1)
+#define TRACE_ADDR(lo)       (((lo) & 0x7FFFFF) << 1)
+
+// Wait state table, relative to SF2000_WAITSTATES
+#define WS_TABLE(n)          ((n) << 2)
+
+#define WS_RAM               0
+#define WS_FLASH             1
+#define WS_IDE               2
+#define WS_SD                3
+#define WS_TABLES            4
+
+// Wait states for speed jumper setting c in a table entry
+#define WS_GET(entry,c)      (((entry) >> ((c) << 2)) & 0xF)
+#define WS_SET(entry,c,n)    (((entry) & ~(0xFUL << ((c) << 2))) | ((ULONG)(n) << ((c) << 2)))
+
+#define SF2000_REG16(base,off) (*(volatile UWORD *)((UBYTE *)(base) + (off)))
+#define SF2000_REG32(base,off) (*(volatile ULONG *)((UBYTE *)(base) + (off)))
+
+// sf2000.c
+ULONG findFlashWindow();
+
+#endif
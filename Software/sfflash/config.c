@@ -19,6 +19,7 @@
 #include <stdbool.h>
 #include <proto/exec.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "main.h"
 #include "flash.h"
@@ -111,6 +112,22 @@ struct Config* configure(int argc, char *argv[]) {
           config->programBank = FLASH_BANK_0;
           break;
 
+        case 'm':
+          if (config-> op == OP_NONE) {
+            if (i+1 < argc && (strcmp(argv[i+1],"on") == 0 || strcmp(argv[i+1],"off") == 0)) {
+              config->op = OP_MAPROM;
+              config->mapromOff = (strcmp(argv[i+1],"off") == 0);
+              i++;
+            } else {
+              error = true;
+              printf("Specify -m on or -m off.\n");
+            }
+          } else {
+            error = true;
+            printf("Only one operation can be performed at a time.\n");
+          }
+          break;
+
         case 'v':
           if (config-> op == OP_NONE) {
             config->op = OP_VERIFY;
@@ -148,7 +165,7 @@ struct Config* configure(int argc, char *argv[]) {
  * @brief Print the usage information
 */
 void usage() {
-    printf("\nUsage: sfflash [-fieEvV] [-c|-f <kickstart rom>] [-0|1] \n\n");
+    printf("\nUsage: sfflash [-fieEvV] [-c|-f <kickstart rom>] [-0|1] | -m on|off\n\n");
     printf("       -c                  -  Copy ROM to Flash.\n");
     printf("       -f <kickstart file> -  Kickstart to Flash or verify.\n");
     printf("       -i                  -  Print Flash device id.\n");
@@ -158,4 +175,5 @@ void usage() {
     printf("       -V                  -  Skip verification after programming.\n");
     printf("       -0                  -  Select bank 0 - $E0 ROM.\n");
     printf("       -1                  -  Select bank 1 - $F8 ROM (default, boot bank).\n");
+    printf("       -m on|off           -  Switch MapROM on or off from the next reset.\n");
 }
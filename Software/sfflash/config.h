@@ -22,7 +22,8 @@ typedef enum {
   OP_VERIFY,
   OP_ERASE_BANK,
   OP_ERASE_CHIP,
-  OP_IDENTIFY
+  OP_IDENTIFY,
+  OP_MAPROM
 } operation_type;
 
 typedef enum {
@@ -36,6 +37,7 @@ struct Config {
   operation_type op;
   source_type    source;
   bool           skipVerify;
+  bool           mapromOff;
   char           *ks_filename;
 };
 
@@ -92,6 +92,8 @@ void flash_erase_sector(UBYTE sector) {
 /** flash_poll
  *
  * @brief Poll the status bits at address, until they indicate that the operation has completed.
+ * After a word program the FPGA holds off reads until RY/BY# is released, so the first pair
+ * of reads normally returns array data and the loop falls straight through. Erase is polled.
  * @param address Address to poll
 */
 void flash_poll(ULONG address) {
@@ -34,8 +34,6 @@
 #define FLASH_SIZE   0x100000
 //
 
-#define FLASHBASE     0xA00000
-
 #define FLASH_BANK_0  0x000000
 #define FLASH_BANK_1  0x080000
 
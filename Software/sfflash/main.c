@@ -28,9 +28,7 @@
 #include "flash.h"
 #include "main.h"
 #include "config.h"
-
-#define MANUF_ID 5194
-#define PROD_ID  10
+#include "sf2000.h"
 
 void *flashbase;
 
@@ -45,9 +43,6 @@ int main(int argc, char *argv[])
 
   int rc = 0;
 
-  // TODO: Perhaps this should be found from autoconfig or something...
-  flashbase = (void *)FLASHBASE;
-
   if (DosBase == NULL) {
     return(rc);
   }
@@ -59,79 +54,55 @@ int main(int argc, char *argv[])
     if ((ExpansionBase = (struct ExpansionBase *)OpenLibrary("expansion.library",0)) != NULL) {
 
       struct ConfigDev *cd = NULL;
+      ULONG window;
 
-      if (cd = (struct ConfigDev*)FindConfigDev(NULL,MANUF_ID,PROD_ID)) {
+      if ((cd = (struct ConfigDev*)FindConfigDev(NULL,SF2000_MANUF_ID,SF2000_CTRL_PROD_ID)) != NULL) {
 
-        UWORD manufacturerId, deviceId;
+        APTR ctrl = (UBYTE *)cd->cd_BoardAddr + SF2000_CONTROL;
+        UWORD control = SF2000_REG16(ctrl,CTRL_CONTROL);
 
-        bool check_device = flash_identify(&manufacturerId,&deviceId);
+        if (config->op == OP_MAPROM) {
 
-        if (check_device == false && config->op != OP_IDENTIFY) {
+          control = (config->mapromOff) ? control | CTRL_MAPROM_OFF : control & ~CTRL_MAPROM_OFF;
+          SF2000_REG16(ctrl,CTRL_CONTROL) = control;
+          printf("MapROM will be %s after the next reset.\n",(config->mapromOff) ? "off" : "on (if JP9 is closed)");
 
-          printf("Error: Expected to see manufacturer id %04X but got %04X instead\n",FLASH_MANUF,manufacturerId);
-          printf("Check that ROM overlay is switched off and try again.\n");
+        } else if (SF2000_REG16(ctrl,CTRL_STATUS) & CTRL_STAT_MAPROM) {
 
-        } else {
+          printf("Error: MapROM is active, the flash can't be programmed.\n");
+          printf("Run sfflash -m off and reset, or open JP9 and try again.\n");
+          rc = 5;
 
-          switch (config->op) {
+        } else if ((window = findFlashWindow()) == 0) {
 
-            case OP_IDENTIFY:
-              printf("Manufacturer: %04X, Device: %04X\n",manufacturerId, deviceId);
-            break;
+          printf("Error: No free 1MB address range between $200000 and $AFFFFF for the flash.\n");
+          rc = 5;
 
-            case OP_VERIFY:
-              if (config->source == SOURCE_ROM) {
-                rc = (verifyBank((ULONG *)0xF80000,config->programBank,ROM_512K)) ? 0 : 5;
-              } else {
-                rc = (verifyFile(config->ks_filename,config->programBank)) ? 0 : 5;
-              }
-              break;
+        } else {
 
-            case OP_ERASE_BANK:
-              erase_bank(config->programBank);
-              break;
+          // Map the flash window, it is only decoded while enabled
+          SF2000_REG16(ctrl,CTRL_FLASH_BASE) = CTRL_FLASH_BASE_REG(window);
+          SF2000_REG16(ctrl,CTRL_CONTROL)    = control | CTRL_FLASH_ENABLE;
+          flashbase = (void *)CTRL_FLASH_BASE_ADDR(SF2000_REG16(ctrl,CTRL_FLASH_BASE));
 
-            case OP_ERASE_CHIP:
-              erase_chip();
-              break;
+          rc = flashOperation(config);
 
-            case OP_PROGRAM:
-              if (config->source == SOURCE_ROM) {
-                erase_bank(config->programBank);
-                printf("Copying Kickstart ROM to bank %d\n",(config->programBank == FLASH_BANK_0) ? 0 : 1);
-                copyBufToFlash((void *)0xF80000,config->programBank,ROM_512K,config->skipVerify);
-              } else {
-                ULONG romSize = 0;
-                printf("Flashing kick file %s\n",config->ks_filename);
-                if ((romSize = getFileSize(config->ks_filename)) != 0) {
-                  if (romSize == ROM_256K || romSize == ROM_512K || romSize == ROM_1M) {
-                    if (romSize == ROM_1M) {
-                      erase_chip();
-                    } else {
-                      erase_bank(config->programBank);
-                    }
-                    if (romSize == ROM_1M) {
-                      // Force Bank 0 for 1M rom as it will fill both banks.
-                      copyFileToFlash(config->ks_filename,FLASH_BANK_0,romSize,config->skipVerify);
-                    } else {
-                      copyFileToFlash(config->ks_filename,config->programBank,romSize,config->skipVerify);
-                    }
-                  } else {
-                    printf("Bad file size, 256K/512K/1M ROM required.\n");
-                    rc = 5;
-                  }
-                }
-              }
-              break;
+          SF2000_REG16(ctrl,CTRL_CONTROL) = control & ~CTRL_FLASH_ENABLE;
+        }
 
-              case OP_NONE:
-                usage();
-                break;
-          }
+      } else if ((cd = (struct ConfigDev*)FindConfigDev(NULL,SF2000_MANUF_ID,SF2000_RAM_PROD_ID)) != NULL) {
+
+        // Bitstreams without the control board always decode the flash at $A00000 while MapROM is off
+        if (config->op == OP_MAPROM) {
+          printf("Error: -m needs a bitstream with the SF2000 control board.\n");
+          rc = 5;
+        } else {
+          flashbase = (void *)SF2000_FLASH_WINDOW;
+          rc = flashOperation(config);
         }
 
       } else {
-        printf("Couldn't find board with Manufacturer/Prod ID of %d:%d\n",MANUF_ID,PROD_ID);
+        printf("Couldn't find board with Manufacturer/Prod ID of %d:%d\n",SF2000_MANUF_ID,SF2000_CTRL_PROD_ID);
         rc = 5;
       }
 
@@ -151,6 +122,88 @@ int main(int argc, char *argv[])
   return (rc);
 }
 
+/**
+ * flashOperation
+ *
+ * @brief Perform the selected operation on the flash, with the flash window mapped
+ * @param config Pointer to the Config
+ * @returns Return code
+*/
+int flashOperation(struct Config *config) {
+  int rc = 0;
+
+  UWORD manufacturerId, deviceId;
+
+  bool check_device = flash_identify(&manufacturerId,&deviceId);
+
+  if (check_device == false && config->op != OP_IDENTIFY) {
+
+    printf("Error: Expected to see manufacturer id %04X but got %04X instead\n",FLASH_MANUF,manufacturerId);
+    printf("Check that ROM overlay is switched off and try again.\n");
+
+  } else {
+
+    switch (config->op) {
+
+      case OP_IDENTIFY:
+        printf("Manufacturer: %04X, Device: %04X\n",manufacturerId, deviceId);
+      break;
+
+      case OP_VERIFY:
+        if (config->source == SOURCE_ROM) {
+          rc = (verifyBank((ULONG *)0xF80000,config->programBank,ROM_512K)) ? 0 : 5;
+        } else {
+          rc = (verifyFile(config->ks_filename,config->programBank)) ? 0 : 5;
+        }
+        break;
+
+      case OP_ERASE_BANK:
+        erase_bank(config->programBank);
+        break;
+
+      case OP_ERASE_CHIP:
+        erase_chip();
+        break;
+
+      case OP_PROGRAM:
+        if (config->source == SOURCE_ROM) {
+          erase_bank(config->programBank);
+          printf("Copying Kickstart ROM to bank %d\n",(config->programBank == FLASH_BANK_0) ? 0 : 1);
+          copyBufToFlash((void *)0xF80000,config->programBank,ROM_512K,config->skipVerify);
+        } else {
+          ULONG romSize = 0;
+          printf("Flashing kick file %s\n",config->ks_filename);
+          if ((romSize = getFileSize(config->ks_filename)) != 0) {
+            if (romSize == ROM_256K || romSize == ROM_512K || romSize == ROM_1M) {
+              if (romSize == ROM_1M) {
+                erase_chip();
+              } else {
+                erase_bank(config->programBank);
+              }
+              if (romSize == ROM_1M) {
+                // Force Bank 0 for 1M rom as it will fill both banks.
+                copyFileToFlash(config->ks_filename,FLASH_BANK_0,romSize,config->skipVerify);
+              } else {
+                copyFileToFlash(config->ks_filename,config->programBank,romSize,config->skipVerify);
+              }
+            } else {
+              printf("Bad file size, 256K/512K/1M ROM required.\n");
+              rc = 5;
+            }
+          }
+        }
+        break;
+
+        case OP_MAPROM:
+        case OP_NONE:
+          usage();
+          break;
+    }
+  }
+
+  return rc;
+}
+
 /**
  * erase_bank
  *
@@ -16,6 +16,8 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+struct Config;
+int flashOperation(struct Config *);
 ULONG getFileSize(char *);
 void copyFileToFlash(char *, ULONG, ULONG, bool);
 void copyBufToFlash(ULONG *, ULONG, ULONG, bool);
@@ -0,0 +1,253 @@
+/*
+ * sfperf - SF2000 performance counter reader
+ *
+ * Samples the on-FPGA bus counters over an interval and prints the
+ * number of bus cycles, wait states and their rates per bus region.
+ */
+
+#include <exec/execbase.h>
+#include <proto/exec.h>
+#include <proto/expansion.h>
+#include <proto/dos.h>
+#include <dos/dos.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "sf2000.h"
+
+#define TICKS_PER_SECOND 50
+#define CALIBRATE_TICKS  10   // CLKCPU measurement for maxSeconds
+
+struct Library *DosBase;
+struct ExecBase *SysBase;
+struct ExpansionBase *ExpansionBase = NULL;
+
+static const char *region_names[REGIONS] = {
+  "Motherboard",
+  "Fast RAM",
+  "Flash/MapROM",
+  "IDE",
+  "SD card",
+  "Autoconfig/Ctrl"
+};
+
+struct Counters {
+  ULONG clocks;
+  ULONG mb_stall;
+  ULONG sd_bytes;
+  ULONG sd_underrun;
+  ULONG bus_cycles[REGIONS];
+  ULONG wait_cycles[REGIONS];
+};
+
+void usage();
+void readCounters(APTR, struct Counters *);
+void printCounters(struct Counters *, ULONG);
+ULONG scale(ULONG, ULONG, ULONG);
+ULONG maxSeconds(APTR);
+
+int main(int argc, char *argv[])
+{
+  SysBase = *((struct ExecBase **)4UL);
+  DosBase = OpenLibrary("dos.library",0);
+
+  int rc = 0;
+  bool readOnly = false;
+  bool clearOnly = false;
+  ULONG seconds = 5;
+
+  if (DosBase == NULL) {
+    return(rc);
+  }
+
+  for (int i=1; i<argc; i++) {
+    if (argv[i][0] == '-') {
+      switch(argv[i][1]) {
+        case 'r':
+          readOnly = true;
+          break;
+
+        case 'c':
+          clearOnly = true;
+          break;
+
+        default:
+          usage();
+          CloseLibrary((struct Library *)DosBase);
+          return(5);
+      }
+    } else {
+      seconds = atoi(argv[i]);
+    }
+  }
+
+  if (seconds == 0) seconds = 1;
+
+  if ((ExpansionBase = (struct ExpansionBase *)OpenLibrary("expansion.library",0)) != NULL) {
+
+    struct ConfigDev *cd = NULL;
+
+    if ((cd = (struct ConfigDev*)FindConfigDev(NULL,SF2000_MANUF_ID,SF2000_CTRL_PROD_ID)) != NULL) {
+
+      APTR perf = (UBYTE *)cd->cd_BoardAddr + SF2000_PERFMON;
+      struct Counters counters;
+
+      if (clearOnly) {
+
+        SF2000_REG16(perf,PERF_CTRL) = PERF_CTRL_CLEAR;
+        printf("Counters cleared.\n");
+
+      } else if (readOnly) {
+
+        // Freeze so all counters are read from the same instant, then let them run on.
+        SF2000_REG16(perf,PERF_CTRL) = PERF_CTRL_FREEZE;
+        readCounters(perf,&counters);
+        SF2000_REG16(perf,PERF_CTRL) = 0;
+        printCounters(&counters,0);
+
+      } else {
+
+        struct DateStamp start, end;
+        ULONG limit = maxSeconds(perf);
+
+        if (seconds > limit) {
+          printf("The 32 bit counters wrap after %lu seconds at this CLKCPU, sampling for %lu seconds.\n",limit,limit);
+          seconds = limit;
+        }
+
+        printf("Sampling for %lu seconds...\n",seconds);
+
+        SF2000_REG16(perf,PERF_CTRL) = PERF_CTRL_FREEZE | PERF_CTRL_CLEAR;
+        DateStamp(&start);
+        SF2000_REG16(perf,PERF_CTRL) = 0;
+        Delay(seconds * TICKS_PER_SECOND);
+        SF2000_REG16(perf,PERF_CTRL) = PERF_CTRL_FREEZE;
+        DateStamp(&end);
+
+        readCounters(perf,&counters);
+        SF2000_REG16(perf,PERF_CTRL) = 0;
+
+        ULONG ticks = (end.ds_Days - start.ds_Days) * 24 * 60 * 60 * TICKS_PER_SECOND +
+                      (end.ds_Minute - start.ds_Minute) * 60 * TICKS_PER_SECOND +
+                      (end.ds_Tick - start.ds_Tick);
+
+        printCounters(&counters,ticks);
+      }
+
+    } else {
+      printf("Couldn't find board with Manufacturer/Prod ID of %d:%d\n",SF2000_MANUF_ID,SF2000_CTRL_PROD_ID);
+      rc = 5;
+    }
+
+  } else {
+    printf("Couldn't open Expansion.library.\n");
+    rc = 5;
+  }
+
+  if (ExpansionBase) CloseLibrary((struct Library *)ExpansionBase);
+  if (DosBase)       CloseLibrary((struct Library *)DosBase);
+
+  return (rc);
+}
+
+/** readCounters
+ *
+ * @brief Copy all counters from the board, they should be frozen while doing so
+ * @param perf Address of the performance counter block
+ * @param counters Pointer to a Counters struct to fill in
+*/
+void readCounters(APTR perf, struct Counters *counters) {
+  counters->clocks      = SF2000_REG32(perf,PERF_CLOCKS);
+  counters->mb_stall    = SF2000_REG32(perf,PERF_MB_STALL);
+  counters->sd_bytes    = SF2000_REG32(perf,PERF_SD_BYTES);
+  counters->sd_underrun = SF2000_REG32(perf,PERF_SD_UNDERRUN);
+
+  for (int i=0; i<REGIONS; i++) {
+    counters->bus_cycles[i]  = SF2000_REG32(perf,PERF_BUS_CYCLES(i));
+    counters->wait_cycles[i] = SF2000_REG32(perf,PERF_WAIT_CYCLES(i));
+  }
+}
+
+/** printCounters
+ *
+ * @brief Print the counters, with rates if the sample interval is known
+ * @param counters Pointer to the counters
+ * @param ticks Length of the sample interval in ticks, or 0 if unknown
+*/
+void printCounters(struct Counters *counters, ULONG ticks) {
+  if (ticks) {
+    printf("Interval: %lu.%02lu s, CLKCPU: %lu kHz\n\n",
+      ticks / TICKS_PER_SECOND, (ticks % TICKS_PER_SECOND) * 2,
+      scale(counters->clocks,TICKS_PER_SECOND,ticks * 1000));
+  } else {
+    printf("CLKCPU cycles: %lu\n\n",counters->clocks);
+  }
+
+  printf("%-16s %10s %10s %10s %8s %7s\n","Region","Cycles","Cycles/s","Waits","Wait/cyc","Wait%");
+
+  for (int i=0; i<REGIONS; i++) {
+    ULONG cycles = counters->bus_cycles[i];
+    ULONG waits  = counters->wait_cycles[i];
+    ULONG avg    = scale(waits,100,cycles);
+
+    printf("%-16s %10lu %10lu %10lu %5lu.%02lu %6lu%%\n",
+      region_names[i],
+      cycles,
+      (ticks) ? scale(cycles,TICKS_PER_SECOND,ticks) : 0,
+      waits,
+      avg / 100, avg % 100,
+      scale(waits,100,counters->clocks));
+  }
+
+  printf("\nMotherboard sync stall: %lu cycles (%lu%%)\n",
+    counters->mb_stall, scale(counters->mb_stall,100,counters->clocks));
+
+  if (ticks) {
+    printf("SD transfer: %lu bytes, %lu bytes/s, %lu underruns\n",
+      counters->sd_bytes, scale(counters->sd_bytes,TICKS_PER_SECOND,ticks), counters->sd_underrun);
+  } else {
+    printf("SD transfer: %lu bytes, %lu underruns\n",counters->sd_bytes,counters->sd_underrun);
+  }
+}
+
+/** scale
+ *
+ * @brief Compute value * mul / div without overflowing
+ * @returns The scaled value, or 0 if div is 0
+*/
+ULONG scale(ULONG value, ULONG mul, ULONG div) {
+  if (div == 0) return 0;
+  return (ULONG)(((unsigned long long)value * mul) / div);
+}
+
+/** maxSeconds
+ *
+ * @brief Measure CLKCPU and work out how long the counters can sample before they wrap
+ * Clears the counters. A margin of 10% covers the tick count of Delay() running late.
+ * @param perf Address of the performance counter block
+ * @returns Longest sample interval in seconds, at least 1
+*/
+ULONG maxSeconds(APTR perf) {
+  SF2000_REG16(perf,PERF_CTRL) = PERF_CTRL_FREEZE | PERF_CTRL_CLEAR;
+  SF2000_REG16(perf,PERF_CTRL) = 0;
+  Delay(CALIBRATE_TICKS);
+  SF2000_REG16(perf,PERF_CTRL) = PERF_CTRL_FREEZE;
+  ULONG perSecond = scale(SF2000_REG32(perf,PERF_CLOCKS),TICKS_PER_SECOND,CALIBRATE_TICKS);
+  SF2000_REG16(perf,PERF_CTRL) = 0;
+
+  ULONG limit = (perSecond) ? scale(0xFFFFFFFFUL / perSecond,9,10) : 1;
+  return (limit) ? limit : 1;
+}
+
+/** usage
+ * @brief Print the usage information
+*/
+void usage() {
+    printf("\nUsage: sfperf [-r|-c] [<seconds>]\n\n");
+    printf("       <seconds>  -  Clear the counters and sample for this long (default 5),\n");
+    printf("                     limited to what the counters hold (about 77 s at 50 MHz).\n");
+    printf("       -r         -  Print the counters accumulated since the last clear,\n");
+    printf("                     they wrap after 2^32 CLKCPU cycles (about 86 s at 50 MHz).\n");
+    printf("       -c         -  Clear the counters.\n");
+}
@@ -0,0 +1,301 @@
+/*
+ * sftrace - SF2000 bus trace tool
+ *
+ * Arms the on-FPGA bus trace with a trigger, waits for the capture to
+ * complete and decodes the recorded bus cycles, followed by a histogram
+ * of the wait states per bus region.
+ */
+
+#include <exec/execbase.h>
+#include <proto/exec.h>
+#include <proto/expansion.h>
+#include <proto/dos.h>
+#include <dos/dos.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "sf2000.h"
+
+#define HIST_BUCKETS 17
+
+struct Library *DosBase;
+struct ExecBase *SysBase;
+struct ExpansionBase *ExpansionBase = NULL;
+
+static const char *region_names[REGIONS] = {
+  "MB",
+  "RAM",
+  "FLASH",
+  "IDE",
+  "SD",
+  "CTRL"
+};
+
+struct Config {
+  ULONG trigLo;
+  ULONG trigHi;
+  UWORD trigType;
+  UWORD trigFc;
+  UWORD post;
+  bool  force;
+  bool  histOnly;
+};
+
+void usage();
+bool configure(int, char *[], struct Config *);
+bool waitForTrace(APTR);
+void dumpTrace(APTR, bool);
+
+int main(int argc, char *argv[])
+{
+  SysBase = *((struct ExecBase **)4UL);
+  DosBase = OpenLibrary("dos.library",0);
+
+  int rc = 0;
+  struct Config config;
+
+  if (DosBase == NULL) {
+    return(rc);
+  }
+
+  if (configure(argc,argv,&config) == false) {
+    usage();
+    CloseLibrary((struct Library *)DosBase);
+    return(5);
+  }
+
+  if ((ExpansionBase = (struct ExpansionBase *)OpenLibrary("expansion.library",0)) != NULL) {
+
+    struct ConfigDev *cd = NULL;
+
+    if ((cd = (struct ConfigDev*)FindConfigDev(NULL,SF2000_MANUF_ID,SF2000_CTRL_PROD_ID)) != NULL) {
+
+      APTR trace = (UBYTE *)cd->cd_BoardAddr + SF2000_BUSTRACE;
+      UWORD depth = SF2000_REG16(trace,TRACE_DEPTH);
+
+      if (config.post >= depth) config.post = depth - 1;
+
+      SF2000_REG16(trace,TRACE_CTRL)      = TRACE_CTRL_STOP;
+      SF2000_REG32(trace,TRACE_TRIG_LO)   = config.trigLo;
+      SF2000_REG32(trace,TRACE_TRIG_HI)   = config.trigHi;
+      SF2000_REG16(trace,TRACE_TRIG_TYPE) = config.trigType;
+      SF2000_REG16(trace,TRACE_TRIG_FC)   = config.trigFc;
+      SF2000_REG16(trace,TRACE_POST)      = config.post;
+      SF2000_REG16(trace,TRACE_CTRL)      = TRACE_CTRL_ARM | ((config.force) ? TRACE_CTRL_FORCE : 0);
+
+      printf("Waiting for trigger, Ctrl-C to stop...\n");
+
+      if (waitForTrace(trace) == false) {
+        SF2000_REG16(trace,TRACE_CTRL) = TRACE_CTRL_STOP;
+        printf("Stopped before trigger.\n");
+        rc = 5;
+      }
+
+      dumpTrace(trace,config.histOnly);
+
+    } else {
+      printf("Couldn't find board with Manufacturer/Prod ID of %d:%d\n",SF2000_MANUF_ID,SF2000_CTRL_PROD_ID);
+      rc = 5;
+    }
+
+  } else {
+    printf("Couldn't open Expansion.library.\n");
+    rc = 5;
+  }
+
+  if (ExpansionBase) CloseLibrary((struct Library *)ExpansionBase);
+  if (DosBase)       CloseLibrary((struct Library *)DosBase);
+
+  return (rc);
+}
+
+/** configure
+ *
+ * @brief Parse the command arguments into the trigger configuration
+ * @param argc Arg count
+ * @param argv Argument variables
+ * @param config Pointer to the Config struct to fill in
+ * @returns false on error
+*/
+bool configure(int argc, char *argv[], struct Config *config) {
+  UWORD regions = 0xFF;
+  UWORD types   = TRACE_TYPE_READ | TRACE_TYPE_WRITE;
+  UWORD minWait = 0;
+  char *end;
+
+  config->trigLo   = 0x000000;
+  config->trigHi   = 0xFFFFFF;
+  config->trigFc   = 0xFF;
+  config->post     = 512;
+  config->force    = false;
+  config->histOnly = false;
+
+  for (int i=1; i<argc; i++) {
+    if (argv[i][0] != '-') return false;
+
+    switch(argv[i][1]) {
+
+      case 'a':
+        if (i+1 >= argc) return false;
+        config->trigLo = strtoul(argv[++i],&end,16);
+        config->trigHi = (*end == '-') ? strtoul(end+1,NULL,16) : config->trigLo + 1;
+        break;
+
+      case 'r':
+        types = TRACE_TYPE_READ;
+        break;
+
+      case 'w':
+        types = TRACE_TYPE_WRITE;
+        break;
+
+      case 'm':
+        if (i+1 >= argc) return false;
+        regions = strtoul(argv[++i],NULL,16) & 0xFF;
+        break;
+
+      case 'f':
+        if (i+1 >= argc) return false;
+        config->trigFc = strtoul(argv[++i],NULL,16) & 0xFF;
+        break;
+
+      case 's':
+        if (i+1 >= argc) return false;
+        minWait = atoi(argv[++i]);
+        if (minWait > 255) minWait = 255;
+        break;
+
+      case 'p':
+        if (i+1 >= argc) return false;
+        config->post = atoi(argv[++i]);
+        break;
+
+      case 't':
+        config->force = true;
+        break;
+
+      case 'H':
+        config->histOnly = true;
+        break;
+
+      default:
+        return false;
+    }
+  }
+
+  config->trigType = (regions << 8) | types;
+  config->trigFc  |= minWait << 8;
+
+  return true;
+}
+
+/** waitForTrace
+ *
+ * @brief Wait until the trace has triggered and stopped recording
+ * @param trace Address of the bus trace block
+ * @returns false if interrupted by Ctrl-C
+*/
+bool waitForTrace(APTR trace) {
+  while (SF2000_REG16(trace,TRACE_CTRL) & TRACE_STAT_RUNNING) {
+    if (SetSignal(0L,SIGBREAKF_CTRL_C) & SIGBREAKF_CTRL_C) {
+      return false;
+    }
+    Delay(1);
+  }
+  return true;
+}
+
+/** dumpTrace
+ *
+ * @brief Decode the recorded entries, oldest first, and print a wait state histogram
+ * @param trace Address of the bus trace block
+ * @param histOnly Only print the histogram
+*/
+void dumpTrace(APTR trace, bool histOnly) {
+  static ULONG hist[REGIONS][HIST_BUCKETS];
+  ULONG maxWait[REGIONS];
+  ULONG totalWait[REGIONS];
+  ULONG cycles[REGIONS];
+
+  UWORD status  = SF2000_REG16(trace,TRACE_CTRL);
+  UWORD depth   = SF2000_REG16(trace,TRACE_DEPTH);
+  UWORD wrPtr   = SF2000_REG16(trace,TRACE_WR_PTR);
+  UWORD trigPtr = SF2000_REG16(trace,TRACE_TRIG_PTR);
+
+  UWORD first = (status & TRACE_STAT_WRAPPED) ? wrPtr : 0;
+  UWORD count = (status & TRACE_STAT_WRAPPED) ? depth : wrPtr;
+
+  ULONG lastTime = 0;
+
+  for (int r=0; r<REGIONS; r++) {
+    for (int b=0; b<HIST_BUCKETS; b++) hist[r][b] = 0;
+    maxWait[r] = totalWait[r] = cycles[r] = 0;
+  }
+
+  if (!histOnly) {
+    printf("\n Entry    Delta  Address  R/W  FC  UDS LDS  Region  Waits\n");
+  }
+
+  SF2000_REG16(trace,TRACE_RD_PTR) = first;
+
+  for (UWORD i=0; i<count; i++) {
+    UWORD index = (first + i) % depth;
+    ULONG hi    = SF2000_REG32(trace,TRACE_DATA);
+    ULONG lo    = SF2000_REG32(trace,TRACE_DATA + 4);
+
+    ULONG time   = TRACE_TIME(hi);
+    ULONG wait   = TRACE_WAIT(hi);
+    ULONG region = TRACE_REGION(lo);
+    ULONG delta  = (i == 0) ? 0 : (time - lastTime) & 0xFFFFFF;
+    lastTime     = time;
+
+    if (region < REGIONS) {
+      hist[region][(wait < HIST_BUCKETS-1) ? wait : HIST_BUCKETS-1]++;
+      if (wait > maxWait[region]) maxWait[region] = wait;
+      totalWait[region] += wait;
+      cycles[region]++;
+    }
+
+    if (!histOnly) {
+      printf("%c%5d %8lu  %06lX   %c   %lu    %c   %c   %-6s %5lu\n",
+        (status & TRACE_STAT_TRIGGERED && index == trigPtr) ? '*' : ' ',
+        (status & TRACE_STAT_TRIGGERED) ? (int)i - (int)((trigPtr - first + depth) % depth) : (int)i,
+        delta,
+        TRACE_ADDR(lo),
+        TRACE_READ(lo) ? 'R' : 'W',
+        TRACE_FC(lo),
+        TRACE_UDS(lo) ? 'U' : '-',
+        TRACE_LDS(lo) ? 'L' : '-',
+        (region < REGIONS) ? region_names[region] : "?",
+        wait);
+    }
+  }
+
+  printf("\n%u entries. Wait state histogram:\n\n%-6s %7s %5s %5s ",count,"Region","Cycles","Avg","Max");
+  for (int b=0; b<HIST_BUCKETS-1; b++) printf("%5d ",b);
+  printf("  16+\n");
+
+  for (int r=0; r<REGIONS; r++) {
+    if (cycles[r] == 0) continue;
+    printf("%-6s %7lu %5lu %5lu ",region_names[r],cycles[r],totalWait[r] / cycles[r],maxWait[r]);
+    for (int b=0; b<HIST_BUCKETS; b++) printf("%5lu ",hist[r][b]);
+    printf("\n");
+  }
+}
+
+/** usage
+ * @brief Print the usage information
+*/
+void usage() {
+    printf("\nUsage: sftrace [-a <lo>[-<hi>]] [-r|-w] [-m <mask>] [-f <mask>] [-s <n>] [-p <n>] [-t] [-H]\n\n");
+    printf("       -a <lo>-<hi>  -  Trigger on addresses lo to hi (hex).\n");
+    printf("       -r            -  Trigger on reads only.\n");
+    printf("       -w            -  Trigger on writes only.\n");
+    printf("       -m <mask>     -  Trigger on these regions (hex, bit 0 MB, 1 RAM, 2 FLASH, 3 IDE, 4 SD, 5 CTRL).\n");
+    printf("       -f <mask>     -  Trigger on these function codes (hex).\n");
+    printf("       -s <n>        -  Trigger on cycles with at least n wait cycles.\n");
+    printf("       -p <n>        -  Entries to record after the trigger (default 512).\n");
+    printf("       -t            -  Trigger immediately.\n");
+    printf("       -H            -  Only print the wait state histogram.\n");
+}
@@ -0,0 +1,572 @@
+/*
+ * sftune - SF2000 wait state tuner
+ *
+ * Steps the wait states of each region down from the current setting
+ * while running read/write/verify stress patterns, then reports the
+ * lowest stable setting and optionally applies it with a safety margin.
+ * Only the entry for the current speed jumper setting is tuned.
+ */
+
+#include <exec/execbase.h>
+#include <exec/memory.h>
+#include <proto/exec.h>
+#include <proto/expansion.h>
+#include <proto/dos.h>
+#include <dos/dos.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "sf2000.h"
+
+#define IDE_MANUF_ID  2092
+#define IDE_PROD_ID   6
+
+#define MAPROMBASE    0xF80000
+
+#define RAM_TEST_SIZE   0x10000
+#define FLASH_TEST_SIZE 0x10000
+
+// IDE task file registers, CS0 is selected by A12 and the register by A11-A9
+#define IDE_REG(n)    (0x1000 + ((n) << 9))
+#define IDE_NSECT     2
+#define IDE_LBA_LOW   3
+#define IDE_LBA_MID   4
+#define IDE_LBA_HIGH  5
+
+// Alternate status, CS1 is selected by A13. Reading it doesn't acknowledge the drive interrupt.
+#define IDE_ALTSTATUS (0x2000 + (6 << 9))
+#define IDE_STAT_BSY  0x80
+#define IDE_STAT_DRDY 0x40
+#define IDE_STAT_DRQ  0x08
+
+#define BUSY_RETRIES  50    // Ticks to wait for a busy drive per tuning step
+
+// SD card clock divider register, 8 bits read/write
+#define SD_CLKDIV     0x00
+
+struct Library *DosBase;
+struct ExecBase *SysBase;
+struct ExpansionBase *ExpansionBase = NULL;
+
+static const char *table_names[WS_TABLES] = {
+  "RAM",
+  "FLASH",
+  "IDE",
+  "SD"
+};
+
+struct Config {
+  int   region;
+  int   margin;
+  int   passes;
+  bool  apply;
+  bool  list;
+  bool  set;
+  ULONG setValue;
+};
+
+struct Target {
+  APTR   base;
+  ULONG  size;
+  APTR   reference;
+  UWORD  mask;                                    // IDE data lines in use
+  UWORD  taskFile[IDE_LBA_HIGH - IDE_NSECT + 1];  // IDE registers to restore
+  UWORD  sdClkdiv;                                // SD clock divider to restore
+};
+
+APTR ws;
+APTR ctrl;
+
+void usage();
+bool configure(int, char *[], struct Config *);
+int findRegion(char *);
+void listTable();
+bool setupTarget(int, struct Target *);
+void freeTarget(int, struct Target *);
+bool beginStep(int, struct Target *);
+void endStep(int, struct Target *);
+bool ideIdle(APTR, UWORD);
+bool stressTest(int, struct Target *, int);
+bool testRam(struct Target *);
+bool testFlash(struct Target *);
+bool testIde(struct Target *);
+bool testSd(struct Target *);
+void tuneRegion(int, struct Config *, UWORD);
+
+int main(int argc, char *argv[])
+{
+  SysBase = *((struct ExecBase **)4UL);
+  DosBase = OpenLibrary("dos.library",0);
+
+  int rc = 0;
+  struct Config config;
+
+  if (DosBase == NULL) {
+    return(rc);
+  }
+
+  if (configure(argc,argv,&config) == false) {
+    usage();
+    CloseLibrary((struct Library *)DosBase);
+    return(5);
+  }
+
+  if ((ExpansionBase = (struct ExpansionBase *)OpenLibrary("expansion.library",0)) != NULL) {
+
+    struct ConfigDev *cd = NULL;
+
+    if ((cd = (struct ConfigDev*)FindConfigDev(NULL,SF2000_MANUF_ID,SF2000_CTRL_PROD_ID)) != NULL) {
+
+      ws   = (UBYTE *)cd->cd_BoardAddr + SF2000_WAITSTATES;
+      ctrl = (UBYTE *)cd->cd_BoardAddr + SF2000_CONTROL;
+      UWORD status = SF2000_REG16(ctrl,CTRL_STATUS);
+
+      if (config.set) {
+
+        SF2000_REG32(ws,WS_TABLE(config.region)) = config.setValue;
+        listTable();
+
+      } else if (config.list) {
+
+        listTable();
+
+      } else if (!(status & CTRL_STAT_TURBO)) {
+
+        printf("Turbo is not active, nothing to tune.\n");
+        rc = 5;
+
+      } else {
+
+        printf("Tuning speed setting %d, %d passes, margin %d.\n",CTRL_STAT_CLKSEL(status),config.passes,config.margin);
+        printf("Fast RAM failures may crash the machine, a reset restores the defaults.\n");
+        printf("The SD test only checks register access, not card transfers.\n\n");
+
+        for (int r=0; r<WS_TABLES; r++) {
+          if (config.region < 0 || config.region == r) {
+            tuneRegion(r,&config,status);
+          }
+        }
+      }
+
+    } else {
+      printf("Couldn't find board with Manufacturer/Prod ID of %d:%d\n",SF2000_MANUF_ID,SF2000_CTRL_PROD_ID);
+      rc = 5;
+    }
+
+  } else {
+    printf("Couldn't open Expansion.library.\n");
+    rc = 5;
+  }
+
+  if (ExpansionBase) CloseLibrary((struct Library *)ExpansionBase);
+  if (DosBase)       CloseLibrary((struct Library *)DosBase);
+
+  return (rc);
+}
+
+/** configure
+ *
+ * @brief Parse the command arguments
+ * @param argc Arg count
+ * @param argv Argument variables
+ * @param config Pointer to the Config struct to fill in
+ * @returns false on error
+*/
+bool configure(int argc, char *argv[], struct Config *config) {
+  config->region = -1;
+  config->margin = 1;
+  config->passes = 4;
+  config->apply  = false;
+  config->list   = false;
+  config->set    = false;
+
+  for (int i=1; i<argc; i++) {
+    if (argv[i][0] != '-') return false;
+
+    switch(argv[i][1]) {
+
+      case 'r':
+        if (i+1 >= argc) return false;
+        if ((config->region = findRegion(argv[++i])) < 0) return false;
+        break;
+
+      case 'm':
+        if (i+1 >= argc) return false;
+        config->margin = atoi(argv[++i]);
+        break;
+
+      case 'p':
+        if (i+1 >= argc) return false;
+        config->passes = atoi(argv[++i]);
+        if (config->passes < 1) config->passes = 1;
+        break;
+
+      case 'a':
+        config->apply = true;
+        break;
+
+      case 'l':
+        config->list = true;
+        break;
+
+      case 's':
+        if (i+2 >= argc) return false;
+        if ((config->region = findRegion(argv[++i])) < 0) return false;
+        config->setValue = strtoul(argv[++i],NULL,16);
+        config->set = true;
+        break;
+
+      default:
+        return false;
+    }
+  }
+
+  return true;
+}
+
+/** findRegion
+ *
+ * @brief Look up a wait state table by name
+ * @returns Table index or -1 if unknown
+*/
+int findRegion(char *name) {
+  for (int r=0; r<WS_TABLES; r++) {
+    if (stricmp(name,table_names[r]) == 0) return r;
+  }
+  printf("Unknown region %s\n",name);
+  return -1;
+}
+
+/** listTable
+ *
+ * @brief Print the wait state table
+*/
+void listTable() {
+  UWORD status = SF2000_REG16(ctrl,CTRL_STATUS);
+
+  printf("Speed setting %d, turbo %s, MapROM %s\n\n",
+    CTRL_STAT_CLKSEL(status),
+    (status & CTRL_STAT_TURBO) ? "on" : "off",
+    (status & CTRL_STAT_MAPROM) ? "on" : "off");
+
+  for (int r=0; r<WS_TABLES; r++) {
+    printf("%-6s $%08lX\n",table_names[r],SF2000_REG32(ws,WS_TABLE(r)));
+  }
+}
+
+/** tuneRegion
+ *
+ * @brief Find the lowest stable wait state setting for a region
+ * @param region Wait state table index
+ * @param config Pointer to the Config
+ * @param status Board status register
+*/
+void tuneRegion(int region, struct Config *config, UWORD status) {
+  struct Target target;
+  int clksel = CTRL_STAT_CLKSEL(status);
+
+  ULONG entry = SF2000_REG32(ws,WS_TABLE(region));
+  int current = WS_GET(entry,clksel);
+  int stable  = current;
+  bool busy   = false;
+
+  printf("%-6s ",table_names[region]);
+
+  if (current == 0) {
+    printf("no wait states at this speed, nothing to tune\n");
+    return;
+  }
+
+  if (setupTarget(region,&target) == false) {
+    return;
+  }
+
+  for (int n=current; n>=0; n--) {
+    bool ok = false;
+    bool started = false;
+
+    for (int retry=0; retry<BUSY_RETRIES && !started; retry++) {
+      if (retry) Delay(1);
+
+      // Nothing else may touch the region while its timing is out of spec.
+      Disable();
+      if ((started = beginStep(region,&target))) {
+        SF2000_REG32(ws,WS_TABLE(region)) = WS_SET(entry,clksel,n);
+        ok = stressTest(region,&target,config->passes);
+        SF2000_REG32(ws,WS_TABLE(region)) = entry;
+        endStep(region,&target);
+      }
+      Enable();
+    }
+
+    if (!started) busy = true;
+    if (!ok) break;
+    stable = n;
+  }
+
+  freeTarget(region,&target);
+
+  int recommended = stable + config->margin;
+  if (recommended > current) recommended = current;
+
+  printf("current %2d, lowest stable %2d, recommended %2d",current,stable,recommended);
+  if (busy) printf(", stopped early (drive busy)");
+
+  if (config->apply) {
+    entry = WS_SET(entry,clksel,recommended);
+    SF2000_REG32(ws,WS_TABLE(region)) = entry;
+    printf(", applied (sftune -s %s %08lX)",table_names[region],entry);
+  }
+  printf("\n");
+}
+
+/** setupTarget
+ *
+ * @brief Locate the region to test and take reference data at the current timing
+ * @returns false if the region can't be tested
+*/
+bool setupTarget(int region, struct Target *target) {
+  struct ConfigDev *cd;
+  ULONG window;
+
+  target->reference = NULL;
+  target->mask = 0xFFFF;
+
+  switch (region) {
+
+    case WS_RAM:
+      if ((target->base = AllocMem(RAM_TEST_SIZE,MEMF_FAST)) == NULL) {
+        printf("no free fast RAM, skipped\n");
+        return false;
+      }
+      target->size = RAM_TEST_SIZE;
+      return true;
+
+    case WS_FLASH:
+      target->size = FLASH_TEST_SIZE;
+      if ((target->reference = AllocMem(FLASH_TEST_SIZE,MEMF_ANY)) == NULL) {
+        printf("couldn't allocate memory, skipped\n");
+        return false;
+      }
+      if (SF2000_REG16(ctrl,CTRL_STATUS) & CTRL_STAT_MAPROM) {
+        target->base = (APTR)MAPROMBASE;
+      } else if ((window = findFlashWindow()) == 0) {
+        FreeMem(target->reference,FLASH_TEST_SIZE);
+        printf("no free address range for the flash, skipped\n");
+        return false;
+      } else {
+        // Map the flash window for the test, it is unmapped again by freeTarget
+        SF2000_REG16(ctrl,CTRL_FLASH_BASE) = CTRL_FLASH_BASE_REG(window);
+        SF2000_REG16(ctrl,CTRL_CONTROL) |= CTRL_FLASH_ENABLE;
+        target->base = (APTR)CTRL_FLASH_BASE_ADDR(SF2000_REG16(ctrl,CTRL_FLASH_BASE));
+      }
+      CopyMem(target->base,target->reference,FLASH_TEST_SIZE);
+      return true;
+
+    case WS_IDE:
+      if ((cd = (struct ConfigDev*)FindConfigDev(NULL,IDE_MANUF_ID,IDE_PROD_ID)) == NULL) {
+        printf("board not found, skipped\n");
+        return false;
+      }
+      target->base = cd->cd_BoardAddr;
+      target->mask = 0;
+
+      // Find the data lines the task file registers are on, an idle drive must be present.
+      Disable();
+      if (ideIdle(target->base,0xFFFF)) {
+        UWORD nsect = SF2000_REG16(target->base,IDE_REG(IDE_NSECT));
+        SF2000_REG16(target->base,IDE_REG(IDE_NSECT)) = 0x5555;
+        target->mask = ~(SF2000_REG16(target->base,IDE_REG(IDE_NSECT)) ^ 0x5555);
+        SF2000_REG16(target->base,IDE_REG(IDE_NSECT)) = 0xAAAA;
+        target->mask &= ~(SF2000_REG16(target->base,IDE_REG(IDE_NSECT)) ^ 0xAAAA);
+        SF2000_REG16(target->base,IDE_REG(IDE_NSECT)) = nsect;
+      }
+      Enable();
+
+      if (target->mask == 0) {
+        printf("no idle drive, skipped\n");
+        return false;
+      }
+      return true;
+
+    case WS_SD:
+      if ((cd = (struct ConfigDev*)FindConfigDev(NULL,SF2000_MANUF_ID,SF2000_SD_PROD_ID)) == NULL) {
+        printf("board not found, skipped\n");
+        return false;
+      }
+      target->base = cd->cd_BoardAddr;
+      target->sdClkdiv = SF2000_REG16(target->base,SD_CLKDIV);
+      return true;
+  }
+
+  return false;
+}
+
+/** freeTarget
+ *
+ * @brief Release what setupTarget allocated
+*/
+void freeTarget(int region, struct Target *target) {
+  if (region == WS_RAM) FreeMem(target->base,target->size);
+  if (target->reference) FreeMem(target->reference,target->size);
+  if (region == WS_FLASH) SF2000_REG16(ctrl,CTRL_CONTROL) &= ~CTRL_FLASH_ENABLE;
+}
+
+/** beginStep
+ *
+ * @brief Prepare a tuning step, called with interrupts disabled
+ * The IDE task file is saved, the drive must not be executing a command.
+ * @returns false if the step has to wait
+*/
+bool beginStep(int region, struct Target *target) {
+  if (region == WS_IDE) {
+    if (!ideIdle(target->base,target->mask)) return false;
+    for (int r=IDE_NSECT; r<=IDE_LBA_HIGH; r++) {
+      target->taskFile[r - IDE_NSECT] = SF2000_REG16(target->base,IDE_REG(r));
+    }
+  }
+  return true;
+}
+
+/** endStep
+ *
+ * @brief Finish a tuning step, called with interrupts disabled and the table entry restored
+ * Writes the IDE task file back before the driver can run again.
+*/
+void endStep(int region, struct Target *target) {
+  if (region == WS_IDE) {
+    for (int r=IDE_NSECT; r<=IDE_LBA_HIGH; r++) {
+      SF2000_REG16(target->base,IDE_REG(r)) = target->taskFile[r - IDE_NSECT];
+    }
+  }
+}
+
+/** ideIdle
+ *
+ * @brief Check that the drive is ready and not executing a command: BSY and DRQ clear, DRDY set
+ * @param base IDE board address
+ * @param mask Data lines of the task file registers, 0xFFFF when not known yet
+*/
+bool ideIdle(APTR base, UWORD mask) {
+  UWORD status = SF2000_REG16(base,IDE_ALTSTATUS);
+  UWORD lowStatus = status & 0xFF;
+  UWORD highStatus = status >> 8;
+  bool low  = (mask & 0x00FF) && (lowStatus & (IDE_STAT_BSY | IDE_STAT_DRDY | IDE_STAT_DRQ)) == IDE_STAT_DRDY;
+  bool high = (mask & 0xFF00) && (highStatus & (IDE_STAT_BSY | IDE_STAT_DRDY | IDE_STAT_DRQ)) == IDE_STAT_DRDY;
+
+  return low || high;
+}
+
+/** stressTest
+ *
+ * @brief Run the stress patterns for a region, called with interrupts disabled
+ * @returns true if all passes verified
+*/
+bool stressTest(int region, struct Target *target, int passes) {
+  bool ok = true;
+
+  for (int p=0; p<passes && ok; p++) {
+    switch (region) {
+      case WS_RAM:   ok = testRam(target);   break;
+      case WS_FLASH: ok = testFlash(target); break;
+      case WS_IDE:   ok = testIde(target);   break;
+      case WS_SD:    ok = testSd(target);    break;
+    }
+  }
+
+  return ok;
+}
+
+/** testRam
+ *
+ * @brief Write and verify fixed, address and walking bit patterns
+*/
+bool testRam(struct Target *target) {
+  static const ULONG patterns[] = {0x00000000, 0xFFFFFFFF, 0x55555555, 0xAAAAAAAA, 0x0000FFFF};
+  volatile ULONG *mem = target->base;
+  ULONG longs = target->size >> 2;
+
+  for (int p=0; p<sizeof(patterns)/sizeof(patterns[0]); p++) {
+    for (ULONG i=0; i<longs; i++) mem[i] = patterns[p];
+    for (ULONG i=0; i<longs; i++) if (mem[i] != patterns[p]) return false;
+  }
+
+  for (ULONG i=0; i<longs; i++) mem[i] = (ULONG)&mem[i];
+  for (ULONG i=0; i<longs; i++) if (mem[i] != (ULONG)&mem[i]) return false;
+
+  for (ULONG i=0; i<longs; i++) {
+    ULONG bit = 1UL << (i & 31);
+    mem[i] = (i & 32) ? ~bit : bit;
+  }
+  for (ULONG i=0; i<longs; i++) {
+    ULONG bit = 1UL << (i & 31);
+    if (mem[i] != ((i & 32) ? ~bit : bit)) return false;
+  }
+
+  return true;
+}
+
+/** testFlash
+ *
+ * @brief Read the flash back and compare it with the reference taken at the default timing
+*/
+bool testFlash(struct Target *target) {
+  volatile UWORD *flash = target->base;
+  UWORD *reference = target->reference;
+
+  for (ULONG i=0; i<(target->size >> 1); i++) {
+    if (flash[i] != reference[i]) return false;
+  }
+
+  return true;
+}
+
+/** testIde
+ *
+ * @brief Write and verify patterns in the IDE task file registers
+*/
+bool testIde(struct Target *target) {
+  for (UWORD v=0; v<256; v++) {
+    UWORD pattern = (v << 8) | (v ^ 0xFF);
+    for (int r=IDE_NSECT; r<=IDE_LBA_HIGH; r++) {
+      SF2000_REG16(target->base,IDE_REG(r)) = pattern ^ (r * 0x1111);
+    }
+    for (int r=IDE_NSECT; r<=IDE_LBA_HIGH; r++) {
+      if ((SF2000_REG16(target->base,IDE_REG(r)) ^ pattern ^ (r * 0x1111)) & target->mask) return false;
+    }
+  }
+
+  return true;
+}
+
+/** testSd
+ *
+ * @brief Write and verify patterns in the SD card clock divider register
+ * Only the register access is tested, no card transfers are made.
+*/
+bool testSd(struct Target *target) {
+  bool ok = true;
+
+  for (UWORD v=0; v<256 && ok; v++) {
+    SF2000_REG16(target->base,SD_CLKDIV) = v;
+    ok = (SF2000_REG16(target->base,SD_CLKDIV) & 0xFF) == v;
+  }
+  SF2000_REG16(target->base,SD_CLKDIV) = target->sdClkdiv;
+
+  return ok;
+}
+
+/** usage
+ * @brief Print the usage information
+*/
+void usage() {
+    printf("\nUsage: sftune [-r <region>] [-m <n>] [-p <n>] [-a] | -l | -s <region> <hex>\n\n");
+    printf("       -r <region>      -  Only tune RAM, FLASH, IDE or SD.\n");
+    printf("       -m <n>           -  Safety margin in wait states (default 1).\n");
+    printf("       -p <n>           -  Stress test passes per setting (default 4).\n");
+    printf("       -a               -  Apply the recommended settings.\n");
+    printf("       -l               -  List the wait state table.\n");
+    printf("       -s <region> <hex> - Set a table entry, e.g. from S:Startup-Sequence.\n");
+}
@@ -10,10 +10,7 @@ module ata(
     input AS_CPU_n,
     input [7:0] BASE_IDE,
     input IDE_CONFIGURED_n,
-    input JP2,
-    input JP3,
-    input JP4,
-    input CPU_SPEED_SWITCH,
+    input [3:0] DELAY,
     output reg ROM_OE_n = 1'b1,
     output reg IDE_IOR_n = 1'b1,
     output reg IDE_IOW_n = 1'b1,
@@ -51,9 +48,7 @@ IDE_A1	<= A[10];
 IDE_A2	<= A[11];
 */
 
-reg [2:0] counter;
-wire [2:0] clksel = {JP2, JP3, JP4};
-wire [2:0] delay_cnt = !CPU_SPEED_SWITCH && (clksel == 3'b101 || clksel == 3'b110) ? 3'd2 : 3'd0;
+reg [3:0] counter;
 
 always @(posedge CLKCPU) begin
 
@@ -63,7 +58,7 @@ always @(posedge CLKCPU) begin
     end else begin
 
         if (IDE_ACCESS) begin
-            if (counter == delay_cnt) begin
+            if (counter == DELAY) begin
                 DTACK_n <= !IDE_ACCESS;
                 counter <= 'd0;
             end else begin
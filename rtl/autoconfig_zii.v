@@ -17,19 +17,23 @@ module autoconfig_zii(
     output reg [7:5] BASE_RAM,
     output reg [7:0] BASE_IDE,
     output reg [7:0] BASE_SD,
+    output reg [7:0] BASE_CTRL,
     output RAM_CONFIGURED_n,
     output IDE_CONFIGURED_n,
     output SD_CONFIGURED_n,
+    output CTRL_CONFIGURED_n,
     output CFGOUT_n
 );
 
 localparam RAM_CARD = 2'b00;
 localparam IDE_CARD = 2'b01;
 localparam SD_CARD = 2'b10;
+localparam CTRL_CARD = 2'b11;
 
-localparam CONFIGURING_RAM = 3'b111;
-localparam CONFIGURING_IDE = 3'b110;
-localparam CONFIGURING_SD  = 3'b100;
+localparam CONFIGURING_RAM  = 4'b1111;
+localparam CONFIGURING_IDE  = 4'b1110;
+localparam CONFIGURING_SD   = 4'b1100;
+localparam CONFIGURING_CTRL = 4'b1000;
 
 localparam [15:0] MFG_ID_OAHR     = 16'h144A; // 5194   - OAHR
 localparam [15:0] MFG_ID_BSC      = 16'h082C; // 2092   - BSC
@@ -37,6 +41,7 @@ localparam [15:0] MFG_ID_BSC      = 16'h082C; // 2092   - BSC
 localparam [7:0]  RAM_PROD_ID = 8'd10;    // 5194/10 - J.Bilander SF2000 RAM
 localparam [7:0]  IDE_PROD_ID = 8'd6;     // 2092/6 - Oktagon 2008, BSC I/O device / A1K.org Community IDE Controller by Matze (64K)
 localparam [7:0]  SD_PROD_ID  = 8'd11;    // 5194/11 - J.Bilander SF2000 SD Card
+localparam [7:0]  CTRL_PROD_ID = 8'd12;   // 5194/12 - J.Bilander SF2000 Control registers
 localparam [15:0] SERIAL      = 16'd0;
 
 /*
@@ -45,15 +50,16 @@ scsi.device v109.3 or oktagon.device v6.10, selectable via jumper.
 */
 
 reg [3:0] data_nyb_out = 4'hF;
-reg [2:0] config_out_n = 3'b111;
-reg [2:0] configured_n = 3'b111;
-reg [2:0] shutup_n = 3'b111;
+reg [3:0] config_out_n = 4'b1111;
+reg [3:0] configured_n = 4'b1111;
+reg [3:0] shutup_n = 4'b1111;
 
 wire autoconfig_access = !CFGIN_n && CFGOUT_n && (A_HIGH == 8'hE8) && !AS_CPU_n;
 
 assign RAM_CONFIGURED_n = configured_n[RAM_CARD];
 assign IDE_CONFIGURED_n = configured_n[IDE_CARD];
 assign SD_CONFIGURED_n  = configured_n[SD_CARD];
+assign CTRL_CONFIGURED_n = configured_n[CTRL_CARD];
 assign CFGOUT_n = |config_out_n;
 
 assign data_out = {data_nyb_out, 12'd0};
@@ -63,7 +69,7 @@ always @(negedge RESET_n or posedge AS_CPU_n) begin
 
     if (!RESET_n) begin
 
-        config_out_n <= 3'b111;
+        config_out_n <= 4'b1111;
 
     end else begin
 
@@ -76,8 +82,8 @@ always @(negedge RESET_n or posedge C7M) begin
 
     if (!RESET_n) begin
 
-        configured_n <= 3'b111;
-        shutup_n <= 3'b111;
+        configured_n <= 4'b1111;
+        shutup_n <= 4'b1111;
 
     end else begin
 
@@ -95,21 +101,25 @@ always @(negedge RESET_n or posedge C7M) begin
                         if (config_out_n == CONFIGURING_RAM) data_nyb_out <= 4'b1110;                 // (00) 1110 Link into memory free list
                         if (config_out_n == CONFIGURING_IDE) data_nyb_out <= JP7 ? 4'b1101 : 4'b1100; // (00) 1101 Optional ROM vector valid
                         if (config_out_n == CONFIGURING_SD)  data_nyb_out <= JP7 ? 4'b1101 : 4'b1100; // (00) 1101 Optional ROM vector valid
+                        if (config_out_n == CONFIGURING_CTRL) data_nyb_out <= 4'b1100;                // (00) 1100 I/O board, no ROM
                     end
                     6'h01: begin
                         if (config_out_n == CONFIGURING_RAM) data_nyb_out <= JP6 ? 4'b0000 : 4'b0111; // (02) 8 or 4 MB RAM
                         if (config_out_n == CONFIGURING_IDE) data_nyb_out <= 4'b0001;                 // (02) 64KB
                         if (config_out_n == CONFIGURING_SD)  data_nyb_out <= 4'b0001;                 // (02) 64KB
+                        if (config_out_n == CONFIGURING_CTRL) data_nyb_out <= 4'b0001;                // (02) 64KB
                     end
                     6'h02: begin
                         if (config_out_n == CONFIGURING_RAM) data_nyb_out <= ~RAM_PROD_ID[7:4];       // (04) Product number RAM
                         if (config_out_n == CONFIGURING_IDE) data_nyb_out <= ~IDE_PROD_ID[7:4];       // (04) Product number IDE
                         if (config_out_n == CONFIGURING_SD)  data_nyb_out <= ~SD_PROD_ID[7:4];       // (04) Product number IDE
+                        if (config_out_n == CONFIGURING_CTRL) data_nyb_out <= ~CTRL_PROD_ID[7:4];    // (04) Product number CTRL
                     end
                     6'h03: begin
                         if (config_out_n == CONFIGURING_RAM) data_nyb_out <= ~RAM_PROD_ID[3:0];       // (06) Product number RAM
                         if (config_out_n == CONFIGURING_IDE) data_nyb_out <= ~IDE_PROD_ID[3:0];       // (06) Product number IDE
                         if (config_out_n == CONFIGURING_SD)  data_nyb_out <= ~SD_PROD_ID[3:0];       // (06) Product number IDE
+                        if (config_out_n == CONFIGURING_CTRL) data_nyb_out <= ~CTRL_PROD_ID[3:0];    // (06) Product number CTRL
                     end
 
                     6'h04: data_nyb_out <= ~4'b1100;             // (08) 1100 Board can be shut up and has preference to be put in 8 Meg space.
@@ -118,21 +128,25 @@ always @(negedge RESET_n or posedge C7M) begin
                     6'h08: begin                                                                      // (10) Manufacturer ID
                         if (config_out_n == CONFIGURING_RAM) data_nyb_out <= ~MFG_ID_OAHR[15:12];
                         if (config_out_n == CONFIGURING_SD)  data_nyb_out <= ~MFG_ID_OAHR[15:12];
+                        if (config_out_n == CONFIGURING_CTRL) data_nyb_out <= ~MFG_ID_OAHR[15:12];
                         if (config_out_n == CONFIGURING_IDE) data_nyb_out <= ~MFG_ID_BSC[15:12];
                     end
                     6'h09: begin                                                                      // (12) Manufacturer ID
                         if (config_out_n == CONFIGURING_RAM) data_nyb_out <= ~MFG_ID_OAHR[11:8];
                         if (config_out_n == CONFIGURING_SD)  data_nyb_out <= ~MFG_ID_OAHR[11:8];
+                        if (config_out_n == CONFIGURING_CTRL) data_nyb_out <= ~MFG_ID_OAHR[11:8];
                         if (config_out_n == CONFIGURING_IDE) data_nyb_out <= ~MFG_ID_BSC[11:8];
                     end
                     6'h0A: begin                                                                      // (14) Manufacturer ID
                         if (config_out_n == CONFIGURING_RAM) data_nyb_out <= ~MFG_ID_OAHR[7:4];
                         if (config_out_n == CONFIGURING_SD)  data_nyb_out <= ~MFG_ID_OAHR[7:4];
+                        if (config_out_n == CONFIGURING_CTRL) data_nyb_out <= ~MFG_ID_OAHR[7:4];
                         if (config_out_n == CONFIGURING_IDE) data_nyb_out <= ~MFG_ID_BSC[7:4];
                     end
                     6'h0B: begin                                                                      // (16) Manufacturer ID
                         if (config_out_n == CONFIGURING_RAM) data_nyb_out <= ~MFG_ID_OAHR[3:0];
                         if (config_out_n == CONFIGURING_SD)  data_nyb_out <= ~MFG_ID_OAHR[3:0];
+                        if (config_out_n == CONFIGURING_CTRL) data_nyb_out <= ~MFG_ID_OAHR[3:0];
                         if (config_out_n == CONFIGURING_IDE) data_nyb_out <= ~MFG_ID_BSC[3:0];
                     end
                     /*
@@ -184,16 +198,22 @@ always @(negedge RESET_n or posedge C7M) begin
                             BASE_SD[7:4] <= data_in[15:12];
                             configured_n[SD_CARD] <= 1'b0;
                         end
+                        if (config_out_n == CONFIGURING_CTRL) begin
+                            BASE_CTRL[7:4] <= data_in[15:12];
+                            configured_n[CTRL_CARD] <= 1'b0;
+                        end
                     end
                     6'h25: begin    // Written first (4A)
                         //if (config_out_n == CONFIGURING_RAM) BASE_RAM[3:0] <= data_in[15:12];
                         if (config_out_n == CONFIGURING_IDE) BASE_IDE[3:0] <= data_in[15:12];
                         if (config_out_n == CONFIGURING_SD)  BASE_SD[3:0] <= data_in[15:12];
+                        if (config_out_n == CONFIGURING_CTRL) BASE_CTRL[3:0] <= data_in[15:12];
                     end
                     6'h26: begin    // (4C) "Shut up" address, if KS decides to not configure a specific device
                         if (config_out_n == CONFIGURING_RAM) shutup_n[RAM_CARD] <= 1'b0;
                         if (config_out_n == CONFIGURING_IDE) shutup_n[IDE_CARD] <= 1'b0;
                         if (config_out_n == CONFIGURING_SD) shutup_n[SD_CARD] <= 1'b0;
+                        if (config_out_n == CONFIGURING_CTRL) shutup_n[CTRL_CARD] <= 1'b0;
                     end
 
                 endcase
@@ -0,0 +1,258 @@
+`timescale 1ns / 1ps
+
+module bustrace(
+    input CLKCPU,
+    input RESET_n,
+    input AS_CPU_n,
+    input DTACK_CPU_n,
+    input [23:1] A,
+    input [2:0] FC,
+    input RW_n,
+    input UDS_n,
+    input LDS_n,
+    input [2:0] REGION,
+    input access,
+    input [15:0] data_in,
+    output reg [15:0] data_out
+);
+
+/*
+Bus trace, located at offset $2000 in the control board.
+
+One entry is recorded into a block RAM ring buffer at the end of every bus cycle,
+accesses to the trace registers themselves are not recorded.
+
+Entry, 4 words:
+[63:40] Timestamp, CLKCPU cycles at the start of the bus cycle
+[39:32] CLKCPU cycles spent waiting for DTACK (saturates at 255)
+[31:29] Region, see perfmon.v
+[28:26] FC
+[25]    RW
+[24]    UDS active
+[23]    LDS active
+[22:0]  A23-A1
+
+Registers:
+$00 CTRL        Write: bit 0: Arm, bit 1: Force trigger, bit 2: Stop
+                Read:  bit 0: Running, bit 1: Triggered, bit 2: Wrapped
+$02 POST        Number of entries recorded after the trigger entry
+$04 WR_PTR      Index of the next entry to be written (read only)
+$06 TRIG_PTR    Index of the trigger entry (read only)
+$08 DEPTH       Number of entries in the buffer (read only)
+$0A TRIG_TYPE   bit 0: Reads, bit 1: Writes, bits 15-8: Region mask
+$0C TRIG_FC     bits 7-0: FC mask, bits 15-8: Minimum wait cycles
+$10 TRIG_LO     Lowest trigger address (32 bit)
+$14 TRIG_HI     Highest trigger address (32 bit)
+$18 RD_PTR      Index of the entry read at $20-$26
+$20 DATA        Entry at RD_PTR (4 words), RD_PTR increments after reading $26
+
+A cycle triggers when it matches all of the trigger conditions. Recording stops POST entries
+after the trigger, leaving DEPTH - POST - 1 entries before it in the buffer.
+*/
+
+localparam DEPTH_BITS = 10;
+localparam DEPTH      = 1 << DEPTH_BITS;
+
+localparam REG_CTRL      = 5'h00;
+localparam REG_POST      = 5'h01;
+localparam REG_WR_PTR    = 5'h02;
+localparam REG_TRIG_PTR  = 5'h03;
+localparam REG_DEPTH     = 5'h04;
+localparam REG_TRIG_TYPE = 5'h05;
+localparam REG_TRIG_FC   = 5'h06;
+localparam REG_TRIG_LO_H = 5'h08;
+localparam REG_TRIG_LO_L = 5'h09;
+localparam REG_TRIG_HI_H = 5'h0A;
+localparam REG_TRIG_HI_L = 5'h0B;
+localparam REG_RD_PTR    = 5'h0C;
+localparam REG_DATA_0    = 5'h10;
+localparam REG_DATA_1    = 5'h11;
+localparam REG_DATA_2    = 5'h12;
+localparam REG_DATA_3    = 5'h13;
+
+reg [63:0] trace_mem [0:DEPTH-1];
+reg [63:0] rd_data;
+
+reg running = 1'b0;
+reg triggered = 1'b0;
+reg wrapped = 1'b0;
+reg force_trig = 1'b0;
+
+reg [DEPTH_BITS-1:0] wr_ptr;
+reg [DEPTH_BITS-1:0] rd_ptr;
+reg [DEPTH_BITS-1:0] trig_ptr;
+reg [DEPTH_BITS-1:0] post = DEPTH / 2;
+reg [DEPTH_BITS-1:0] post_left;
+
+reg [1:0] trig_rw = 2'b11;
+reg [7:0] trig_region = 8'hFF;
+reg [7:0] trig_fc = 8'hFF;
+reg [7:0] trig_wait = 8'd0;
+reg [23:0] trig_lo = 24'h000000;
+reg [23:0] trig_hi = 24'hFFFFFF;
+
+reg [23:0] timestamp;
+
+// Current bus cycle
+reg as_q = 1'b1;
+reg dtack_q = 1'b1;
+reg [23:0] cur_time;
+reg [7:0] cur_wait;
+reg [2:0] cur_region;
+reg [2:0] cur_fc;
+reg cur_rw;
+reg cur_uds;
+reg cur_lds;
+reg [23:1] cur_addr;
+reg cur_self;
+reg rd_last;
+
+wire cycle_start = !AS_CPU_n && as_q;
+wire cycle_end = AS_CPU_n && !as_q;
+
+wire wr_access = access && !RW_n && !(UDS_n && LDS_n);
+
+wire trig_match = trig_rw[cur_rw ? 0 : 1]          &&
+                  trig_region[cur_region]          &&
+                  trig_fc[cur_fc]                  &&
+                  cur_wait >= trig_wait            &&
+                  {cur_addr, 1'b0} >= trig_lo      &&
+                  {cur_addr, 1'b0} <= trig_hi;
+
+wire record = cycle_end && running && !cur_self;
+
+always @(posedge CLKCPU) begin
+
+    timestamp <= timestamp + 1'b1;
+    as_q      <= AS_CPU_n;
+    dtack_q   <= DTACK_CPU_n;
+
+    if (cycle_start) begin
+        cur_time   <= timestamp;
+        cur_wait   <= 8'd0;
+        cur_region <= REGION;
+        cur_fc     <= FC;
+        cur_rw     <= RW_n;
+        cur_addr   <= A;
+        cur_uds    <= !UDS_n;
+        cur_lds    <= !LDS_n;
+        cur_self   <= access;
+        rd_last    <= 1'b0;
+    end else if (!AS_CPU_n) begin
+        // Data strobes are late in write cycles
+        cur_uds  <= cur_uds || !UDS_n;
+        cur_lds  <= cur_lds || !LDS_n;
+        cur_self <= cur_self || access;
+        rd_last  <= rd_last || (access && RW_n && A[5:1] == REG_DATA_3);
+
+        if (dtack_q && cur_wait != 8'hFF) begin
+            cur_wait <= cur_wait + 1'b1;
+        end
+    end
+
+end
+
+always @(posedge CLKCPU) begin
+
+    if (record) begin
+        trace_mem[wr_ptr] <= {cur_time, cur_wait, cur_region, cur_fc, cur_rw, cur_uds, cur_lds, cur_addr};
+    end
+
+    rd_data <= trace_mem[rd_ptr];
+
+end
+
+always @(posedge CLKCPU) begin
+
+    if (!RESET_n) begin
+
+        running    <= 1'b0;
+        triggered  <= 1'b0;
+        wrapped    <= 1'b0;
+        force_trig <= 1'b0;
+        wr_ptr     <= 'd0;
+        rd_ptr     <= 'd0;
+
+    end else begin
+
+        if (record) begin
+
+            wr_ptr <= wr_ptr + 1'b1;
+
+            if (wr_ptr == DEPTH - 1) begin
+                wrapped <= 1'b1;
+            end
+
+            if (!triggered) begin
+                if (force_trig || trig_match) begin
+                    triggered  <= 1'b1;
+                    force_trig <= 1'b0;
+                    trig_ptr   <= wr_ptr;
+                    post_left  <= post;
+                    running    <= post != 'd0;
+                end
+            end else begin
+                post_left <= post_left - 1'b1;
+                running   <= post_left != 'd1;
+            end
+
+        end
+
+        if (cycle_end && rd_last) begin
+            rd_ptr <= rd_ptr + 1'b1;
+        end
+
+        if (wr_access) begin
+
+            case (A[5:1])
+
+                REG_CTRL: begin
+                    if (data_in[0]) begin
+                        running   <= 1'b1;
+                        triggered <= 1'b0;
+                        wrapped   <= 1'b0;
+                        wr_ptr    <= 'd0;
+                    end
+                    if (data_in[1]) force_trig <= 1'b1;
+                    if (data_in[2]) running <= 1'b0;
+                end
+                REG_POST:      post <= data_in[DEPTH_BITS-1:0];
+                REG_TRIG_TYPE: {trig_region, trig_rw} <= {data_in[15:8], data_in[1:0]};
+                REG_TRIG_FC:   {trig_wait, trig_fc} <= data_in;
+                REG_TRIG_LO_H: trig_lo[23:16] <= data_in[7:0];
+                REG_TRIG_LO_L: trig_lo[15:0] <= data_in;
+                REG_TRIG_HI_H: trig_hi[23:16] <= data_in[7:0];
+                REG_TRIG_HI_L: trig_hi[15:0] <= data_in;
+                REG_RD_PTR:    rd_ptr <= data_in[DEPTH_BITS-1:0];
+
+            endcase
+
+        end
+    end
+end
+
+always @(*) begin
+
+    case (A[5:1])
+        REG_CTRL:      data_out = {13'd0, wrapped, triggered, running};
+        REG_POST:      data_out = post;
+        REG_WR_PTR:    data_out = wr_ptr;
+        REG_TRIG_PTR:  data_out = trig_ptr;
+        REG_DEPTH:     data_out = DEPTH;
+        REG_TRIG_TYPE: data_out = {trig_region, 6'd0, trig_rw};
+        REG_TRIG_FC:   data_out = {trig_wait, trig_fc};
+        REG_TRIG_LO_H: data_out = trig_lo[23:16];
+        REG_TRIG_LO_L: data_out = trig_lo[15:0];
+        REG_TRIG_HI_H: data_out = trig_hi[23:16];
+        REG_TRIG_HI_L: data_out = trig_hi[15:0];
+        REG_RD_PTR:    data_out = rd_ptr;
+        REG_DATA_0:    data_out = rd_data[63:48];
+        REG_DATA_1:    data_out = rd_data[47:32];
+        REG_DATA_2:    data_out = rd_data[31:16];
+        REG_DATA_3:    data_out = rd_data[15:0];
+        default:       data_out = 16'd0;
+    endcase
+
+end
+
+endmodule
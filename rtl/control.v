@@ -0,0 +1,105 @@
+`timescale 1ns / 1ps
+
+module control(
+    input CLKCPU,
+    input RESET_n,
+    input JP2,
+    input JP3,
+    input JP4,
+    input JP6,
+    input JP7,
+    input JP8,
+    input JP9,
+    input CPU_SPEED_SWITCH,
+    input MAPROM_ENABLED,
+    input FLASH_BUSY_n,
+    input access,
+    input RW_n,
+    input DS_n,
+    input [3:1] A,
+    input [15:0] data_in,
+    output reg [15:0] data_out,
+    output [2:0] CLKSEL,
+    output reg FLASH_ENABLE = 1'b0,
+    output reg [23:20] FLASH_BASE = 4'hA,
+    output reg MAPROM_OFF = 1'b0
+);
+
+/*
+Board control registers, located at offset $0000 in the control board.
+
+Registers:
+$00 ID          $5346 ("SF") (read only)
+$02 REVISION    Register map revision, 1 (read only)
+$04 STATUS      bits 2-0: Speed setting in use, bit 3: Turbo active, bit 4: MapROM active,
+                bit 5: Flash busy, bits 11-8: JP9-JP6, bits 14-12: JP2-JP4, jumper bits read 1 when open (read only)
+$06 CONTROL     bit 0: Flash window enabled, cleared on reset
+                bit 1: MapROM off from the next reset, overrides JP9
+                bit 2: Use bits 6-4 instead of JP2-JP4 as speed setting from the next reset
+                bits 6-4: Speed setting
+$08 FLASH_BASE  bits 7-4: A23-A20 of the 1MB flash window, default $A0 ($A00000), reset on reset.
+                Only $20-$A0 are accepted, the window would otherwise cover chip RAM (up to 2MB),
+                the CIAs, the custom chips, autoconfig or the ROM. Where it overlaps the fast RAM
+                the RAM is accessed, keep it clear of the fast RAM and other boards.
+
+The flash is only decoded in the flash window while it is enabled and MapROM is off,
+otherwise the window is left free for other expansions.
+MAPROM_OFF and the speed setting are kept over reset and only cleared at power on,
+they are applied while RESET_n is low since the clock can't be switched safely with the CPU running.
+*/
+
+localparam [15:0] BOARD_ID = 16'h5346;
+localparam [15:0] REVISION = 16'd1;
+
+localparam REG_ID         = 3'h0;
+localparam REG_REVISION   = 3'h1;
+localparam REG_STATUS     = 3'h2;
+localparam REG_CONTROL    = 3'h3;
+localparam REG_FLASH_BASE = 3'h4;
+
+reg clk_override = 1'b0;        // As written to CONTROL
+reg [2:0] clk_setting = 3'd0;
+reg clk_override_active = 1'b0; // Latched on reset
+reg [2:0] clk_setting_active = 3'd0;
+
+assign CLKSEL = clk_override_active ? clk_setting_active : {JP2, JP3, JP4};
+
+always @(posedge CLKCPU) begin
+
+    if (!RESET_n) begin
+
+        FLASH_ENABLE        <= 1'b0;
+        FLASH_BASE          <= 4'hA;
+        clk_override_active <= clk_override;
+        clk_setting_active  <= clk_setting;
+
+    end else if (access && !RW_n && !DS_n) begin
+
+        if (A == REG_CONTROL) begin
+            FLASH_ENABLE <= data_in[0];
+            MAPROM_OFF   <= data_in[1];
+            clk_override <= data_in[2];
+            clk_setting  <= data_in[6:4];
+        end
+
+        if (A == REG_FLASH_BASE && data_in[7:4] >= 4'h2 && data_in[7:4] <= 4'hA) begin
+            FLASH_BASE <= data_in[7:4];
+        end
+
+    end
+end
+
+always @(*) begin
+
+    case (A)
+        REG_ID:         data_out = BOARD_ID;
+        REG_REVISION:   data_out = REVISION;
+        REG_STATUS:     data_out = {1'b0, JP2, JP3, JP4, JP9, JP8, JP7, JP6, 2'b00, !FLASH_BUSY_n, MAPROM_ENABLED, !CPU_SPEED_SWITCH, CLKSEL};
+        REG_CONTROL:    data_out = {9'd0, clk_setting, 1'b0, clk_override, MAPROM_OFF, FLASH_ENABLE};
+        REG_FLASH_BASE: data_out = {8'd0, FLASH_BASE, 4'd0};
+        default:        data_out = 16'd0;
+    endcase
+
+end
+
+endmodule
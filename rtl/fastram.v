@@ -12,6 +12,7 @@ module fastram(
     input DS_n,
     input [7:5] BASE_RAM,
     input RAM_CONFIGURED_n,
+    input [3:0] DELAY,
     output OE_BANK0_n,
     output OE_BANK1_n,
     output WE_BANK0_ODD_n,
@@ -22,6 +23,7 @@ module fastram(
     output reg DTACK_n = 1'b1
 );
 
+reg [3:0] counter;
 
 /*
 Amiga memory map Z2-space:
@@ -51,8 +53,21 @@ always @(posedge CLKCPU or posedge AS_CPU_n) begin
 
     if (AS_CPU_n) begin
         DTACK_n <= 1'b1;
+        counter <= 'd0;
     end else begin
-        DTACK_n <= !RAM_ACCESS;
+
+        if (RAM_ACCESS) begin
+            if (counter == DELAY) begin
+                DTACK_n <= 1'b0;
+            end else begin
+                DTACK_n <= 1'b1;
+                counter <= counter + 1'b1;
+            end
+        end else begin
+            DTACK_n <= 1'b1;
+            counter <= 'd0;
+        end
+
     end
 end
 
@@ -5,13 +5,16 @@ module flash (
     input RESET_n,
     input DS_n,
     input RW_n,
-    input JP2,
-    input JP3,
-    input JP4,
     input JP9,
-    input CPU_SPEED_SWITCH,
+    input [3:0] DELAY,
+    input FLASH_ENABLE,
+    input [23:20] FLASH_BASE,
+    input RAM_ACCESS,
+    input MAPROM_OFF,
     input FLASH_BUSY_n,
+    input [7:0] data_in,
     output FLASH_ACCESS,
+    output MAPROM_ENABLED,
     output FLASH_A19,
     output FLASH_RESET_n,
     output reg FLASH_WE_n = 1'b1,
@@ -21,18 +24,32 @@ module flash (
 
 reg OVL;
 reg maprom_enabled;
-reg [2:0] counter;
-
-wire [2:0] clksel = {JP2, JP3, JP4};
-wire [2:0] delay_cnt = !CPU_SPEED_SWITCH && (clksel == 3'b101 || clksel == 3'b110) ? (JP9 ? 3'd2 : 3'd3) : 3'd0;
+reg [3:0] counter;
+reg [1:0] busy_sync = 2'b11;    // FLASH_BUSY_n (RY/BY#) synchronized to CLKCPU
+reg [3:0] busy_guard = 4'd0;    // Covers tBY, the delay from WE# to RY/BY# going low
+reg program_cmd = 1'b0;         // Last command written was Word-Program, not Erase
 
+assign MAPROM_ENABLED = maprom_enabled;
 assign FLASH_A19 = A[19] || OVL; // Force bank 1 for early boot overlay.
 assign FLASH_RESET_n = RESET_n;
 
-assign FLASH_ACCESS = A[23:20] == 4'hA     && !maprom_enabled               || // $A00000-AFFFFF
-                      A[23:20] == 4'b0     &&  maprom_enabled && OVL        || // $000000-0FFFFF - Early boot overlay
-                      A[23:19] == 5'b11111 &&  maprom_enabled               || // $F80000-FFFFFF
-                      A[23:19] == 5'b11100 &&  maprom_enabled;                 // $E00000-E7FFFF
+// The fast RAM wins if the flash window was put on top of it, the flash is never driven with the SRAM.
+assign FLASH_ACCESS = A[23:20] == FLASH_BASE && !maprom_enabled && FLASH_ENABLE && !RAM_ACCESS || // Flash window, $A00000-AFFFFF by default
+                      A[23:20] == 4'b0       &&  maprom_enabled && OVL                         || // $000000-0FFFFF - Early boot overlay
+                      A[23:19] == 5'b11111   &&  maprom_enabled                                || // $F80000-FFFFFF
+                      A[23:19] == 5'b11100   &&  maprom_enabled;                                  // $E00000-E7FFFF
+
+/*
+While the flash is busy programming a word, reads from the flash window are held off
+by withholding DTACK until RY/BY# is released. The read then returns array data instead of
+DQ6 toggle status, so software needs no polling loop to wait for completion.
+Program takes about 10 us. Sector and chip erase take tens of ms, holding the CPU that long
+would starve interrupts, so after an Erase command ($80 to $555) reads are not held off
+and software polls DQ6 as before.
+The flash address lines are wired straight to the CPU, hence the SDP unlock and command
+writes still have to be issued by software.
+*/
+wire flash_busy = (!busy_sync[1] || busy_guard != 4'd0) && program_cmd && !maprom_enabled;
 
 always @(posedge CLKCPU or posedge AS_CPU_n) begin
 
@@ -42,7 +59,10 @@ always @(posedge CLKCPU or posedge AS_CPU_n) begin
     end else begin
 
         if (FLASH_ACCESS) begin
-            if (counter == delay_cnt) begin
+            if (flash_busy && RW_n) begin
+                DTACK_n <= 1'b1;
+                counter <= 'd0;
+            end else if (counter == DELAY) begin
                 DTACK_n <= !FLASH_ACCESS;
                 counter <= 'd0;
             end else begin
@@ -64,10 +84,23 @@ always @(posedge CLKCPU) begin
         FLASH_OE_n     <= 1;
         FLASH_WE_n     <= 1;
         OVL            <= 1;
-        maprom_enabled <= ~JP9; // Enable flash overlay at next boot
+        maprom_enabled <= ~JP9 && !MAPROM_OFF; // Enable flash overlay at next boot
+        busy_sync      <= 2'b11;
+        busy_guard     <= 4'd0;
+        program_cmd    <= 1'b0;
 
     end else begin
 
+        busy_sync <= {busy_sync[0], FLASH_BUSY_n};
+
+        if (FLASH_ACCESS && !AS_CPU_n && !RW_n && !DS_n) begin
+            busy_guard <= 4'd15;
+            if (A[11:1] == 11'h555 && data_in[7:0] == 8'hA0) program_cmd <= 1'b1;
+            if (A[11:1] == 11'h555 && data_in[7:0] == 8'h80) program_cmd <= 1'b0;
+        end else if (busy_guard != 4'd0) begin
+            busy_guard <= busy_guard - 1'b1;
+        end
+
         if (A[23:16] == 8'hBF && !AS_CPU_n && !RW_n) begin
             OVL <= 0; // Disable rom overlay after CIA write
         end
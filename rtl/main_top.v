@@ -95,6 +95,7 @@ wire ds_n = LDS_n & UDS_n;      // Data Strobe
 wire [7:5] base_ram;            // base address for the RAM_CARD in Z2-space. (A23-A21)
 wire [7:0] base_ide;            // base address for the IDE_CARD in Z2-space. (A23-A16)
 wire [7:0] base_sd;             // base address for the SD_CARD in Z2-space. (A23-A16)
+wire [7:0] base_ctrl;           // base address for the CTRL_CARD in Z2-space. (A23-A16)
 
 wire ram_configured_n;          // keeps track if RAM_CARD is autoconfigured ok.
 wire ram_access;                // keeps track if local SRAM is being accessed.
@@ -104,11 +105,23 @@ wire sd_configured_n;           // keeps track if SDs_CARD is autoconfigured ok.
 wire sd_access;                 // keeps track if the sd is being accessed.
 wire flash_access;              // keeps track if the Flash is being accessed.
 wire sdcard_access;
+wire ctrl_configured_n;         // keeps track if CTRL_CARD is autoconfigured ok.
+wire ctrl_access;               // keeps track if the control registers are being accessed.
 
 wire ide_rom_oe_n;
 wire sd_rom_oe_n;
-
-wire as_internal = AS_CPU_n || ram_access || ide_access || flash_access || sdcard_access;
+wire maprom_enabled;
+wire [2:0] clksel;              // speed setting in use, JP2-JP4 unless overridden from the control board.
+wire flash_enable;              // flash window enabled from the control board.
+wire [23:20] flash_base;        // flash window base address. (A23-A20)
+wire maprom_off;
+
+wire [3:0] ram_delay;           // wait states from the wait state table.
+wire [3:0] flash_delay;
+wire [3:0] ide_delay;
+wire [3:0] sd_delay;
+
+wire as_internal = AS_CPU_n || ram_access || ide_access || flash_access || sdcard_access || ctrl_access;
 wire as_n = dma_n ? AS_CPU_n : AS_MB_n;
 wire mb_dtack_n = cpu_speed_switch ? DTACK_MB_n : dtack_mobo_n;
 wire m6800_dtack_n;
@@ -116,8 +129,9 @@ wire ide_dtack_n;
 wire ram_dtack_n;
 wire flash_dtack_n;
 wire sdcard_dtack_n;
+reg ctrl_dtack_n = 1'b1;
 
-assign DTACK_CPU_n = mb_dtack_n & m6800_dtack_n & ide_dtack_n & ram_dtack_n & flash_dtack_n & sdcard_dtack_n;
+assign DTACK_CPU_n = mb_dtack_n & m6800_dtack_n & ide_dtack_n & ram_dtack_n & flash_dtack_n & sdcard_dtack_n & ctrl_dtack_n;
 
 assign BR_n = bus_req_n ? 1'b0 : 1'bZ;
 assign BR_68SEC000_n = br2_n ? BR_n & BGACK_n : 1'bZ;
@@ -216,9 +230,9 @@ clock clkcontrol(
     .OSC_CLK_X1(OSC_CLK_X1),
     .RESET_n(RESET_n),
     .CPU_SPEED_SWITCH(cpu_speed_switch),
-    .JP2(JP2),
-    .JP3(JP3),
-    .JP4(JP4),
+    .JP2(clksel[2]),
+    .JP3(clksel[1]),
+    .JP4(clksel[0]),
     .AS_CPU_n(AS_CPU_n),
     .DTACK_CPU_n(DTACK_CPU_n),
     .CLKCPU(CLKCPU)
@@ -257,9 +271,11 @@ autoconfig_zii autoconfig(
     .BASE_RAM(base_ram[7:5]),
     .BASE_IDE(base_ide[7:0]),
     .BASE_SD(base_sd[7:0]),
+    .BASE_CTRL(base_ctrl[7:0]),
     .RAM_CONFIGURED_n(ram_configured_n),
     .IDE_CONFIGURED_n(ide_configured_n),
     .SD_CONFIGURED_n(sd_configured_n),
+    .CTRL_CONFIGURED_n(ctrl_configured_n),
     .CFGOUT_n(CFGOUT_n)
 );
 
@@ -275,6 +291,7 @@ fastram ramcontrol(
     .DS_n(ds_n),
     .BASE_RAM(base_ram[7:5]),
     .RAM_CONFIGURED_n(ram_configured_n),
+    .DELAY(ram_delay),
     .OE_BANK0_n(OE_BANK0_n),
     .OE_BANK1_n(OE_BANK1_n),
     .WE_BANK0_ODD_n(WE_BANK0_ODD_n),
@@ -295,10 +312,7 @@ ata idecontrol(
     .AS_CPU_n(AS_CPU_n),
     .BASE_IDE(base_ide[7:0]),
     .IDE_CONFIGURED_n(ide_configured_n),
-    .JP2(JP2),
-    .JP3(JP3),
-    .JP4(JP4),
-    .CPU_SPEED_SWITCH(cpu_speed_switch),
+    .DELAY(ide_delay),
     .ROM_OE_n(ide_rom_oe_n),
     .IDE_IOR_n(IDE_IOR_n),
     .IDE_IOW_n(IDE_IOW_n),
@@ -314,14 +328,17 @@ flash romoverlay(
     .RESET_n(RESET_n),
     .DS_n(ds_n),
     .RW_n(RW_n),
-    .JP2(JP2),
-    .JP3(JP3),
-    .JP4(JP4),
     .JP9(JP9),
-    .CPU_SPEED_SWITCH(cpu_speed_switch),
+    .DELAY(flash_delay),
+    .FLASH_ENABLE(flash_enable),
+    .FLASH_BASE(flash_base),
+    .RAM_ACCESS(ram_access),
+    .MAPROM_OFF(maprom_off),
     .FLASH_BUSY_n(FLASH_BUSY_n),
+    .data_in(D[7:0]),
     .FLASH_A19(FLASH_A19),
     .FLASH_ACCESS(flash_access),
+    .MAPROM_ENABLED(maprom_enabled),
     .FLASH_RESET_n(FLASH_RESET_n),
     .FLASH_OE_n(FLASH_OE_n),
     .FLASH_WE_n(FLASH_WE_n),
@@ -331,6 +348,7 @@ flash romoverlay(
 wire [15:0] sd_data_in = D;
 wire [15:0] sd_data_out;
 wire sd_data_oe;
+wire sd_underrun_t;
 
 assign sdcard_access = !AS_CPU_n && A[23:16] == base_sd && sd_configured_n == 0;
 
@@ -344,6 +362,7 @@ sdcard sdcard_inst(
     .RW(RW_n),
     .UDS_n(UDS_n),
     .LDS_n(LDS_n),
+    .DELAY(sd_delay),
 
     .dtack_n(sdcard_dtack_n),
 
@@ -352,6 +371,7 @@ sdcard sdcard_inst(
     .data_oe(sd_data_oe),
     .ROM_OE_n(sd_rom_oe_n),
     .INT2_n(INT2_n),
+    .UNDERRUN_T(sd_underrun_t),
 
     .SS_n(SD_SS_n),
     .SCLK(SD_SCLK),
@@ -362,8 +382,138 @@ sdcard sdcard_inst(
 
 assign ROM_OE_n = ide_rom_oe_n && sd_rom_oe_n;
 
-wire [15:0] data_out = ac_data_oe ? ac_data_out : sd_data_out;
-wire data_oe = ac_data_oe || sd_data_oe;
+/*
+Control board, 64KB in Z2-space. A15-A12 selects the register block:
+$0000: Board control, IDs, status and the flash window
+$1000: Performance counters
+$2000: Bus trace
+$3000: Wait state table
+*/
+assign ctrl_access = !AS_CPU_n && A[23:16] == base_ctrl && ctrl_configured_n == 0;
+
+wire control_access = ctrl_access && A[15:12] == 4'h0;
+wire perfmon_access = ctrl_access && A[15:12] == 4'h1;
+wire bustrace_access = ctrl_access && A[15:12] == 4'h2;
+wire waitstates_access = ctrl_access && A[15:12] == 4'h3;
+
+always @(posedge CLKCPU or posedge AS_CPU_n) begin
+
+    if (AS_CPU_n) begin
+        ctrl_dtack_n <= 1'b1;
+    end else begin
+        ctrl_dtack_n <= !ctrl_access;
+    end
+end
+
+// Bus region of the current cycle, as counted by the performance counters and recorded by the bus trace.
+wire autoconfig_region = !CFGIN_n && CFGOUT_n && A[23:16] == 8'hE8;
+wire ide_region = !ide_configured_n && A[23:16] == base_ide;
+
+wire [2:0] bus_region = ram_access                       ? 3'd1 :
+                        flash_access                     ? 3'd2 :
+                        ide_region                       ? 3'd3 :
+                        sdcard_access                    ? 3'd4 :
+                        autoconfig_region || ctrl_access ? 3'd5 :
+                                                           3'd0;
+
+wire sd_xfer = sdcard_access && A[4] && !ds_n && (!RW_n || sd_data_oe);
+
+wire [15:0] perfmon_data_out;
+
+perfmon perfcounters(
+    .CLKCPU(CLKCPU),
+    .RESET_n(RESET_n),
+    .AS_CPU_n(AS_CPU_n),
+    .AS_MB_n(AS_MB_n),
+    .DTACK_CPU_n(DTACK_CPU_n),
+    .REGION(bus_region),
+    .SD_XFER(sd_xfer),
+    .SD_WORD(!UDS_n && !LDS_n),
+    .SD_UNDERRUN_T(sd_underrun_t),
+    .access(perfmon_access),
+    .RW_n(RW_n),
+    .DS_n(ds_n),
+    .A(A[6:1]),
+    .data_in(D),
+    .data_out(perfmon_data_out)
+);
+
+wire [15:0] bustrace_data_out;
+
+bustrace bustracer(
+    .CLKCPU(CLKCPU),
+    .RESET_n(RESET_n),
+    .AS_CPU_n(AS_CPU_n),
+    .DTACK_CPU_n(DTACK_CPU_n),
+    .A(A[23:1]),
+    .FC(FC),
+    .RW_n(RW_n),
+    .UDS_n(UDS_n),
+    .LDS_n(LDS_n),
+    .REGION(bus_region),
+    .access(bustrace_access),
+    .data_in(D),
+    .data_out(bustrace_data_out)
+);
+
+wire [15:0] waitstates_data_out;
+
+waitstates waitstatetable(
+    .CLKCPU(CLKCPU),
+    .RESET_n(RESET_n),
+    .JP2(clksel[2]),
+    .JP3(clksel[1]),
+    .JP4(clksel[0]),
+    .JP9(JP9),
+    .CPU_SPEED_SWITCH(cpu_speed_switch),
+    .access(waitstates_access),
+    .RW_n(RW_n),
+    .DS_n(ds_n),
+    .A(A[5:1]),
+    .data_in(D),
+    .data_out(waitstates_data_out),
+    .RAM_DELAY(ram_delay),
+    .FLASH_DELAY(flash_delay),
+    .IDE_DELAY(ide_delay),
+    .SD_DELAY(sd_delay)
+);
+
+wire [15:0] control_data_out;
+
+control boardcontrol(
+    .CLKCPU(CLKCPU),
+    .RESET_n(RESET_n),
+    .JP2(JP2),
+    .JP3(JP3),
+    .JP4(JP4),
+    .JP6(JP6),
+    .JP7(JP7),
+    .JP8(JP8),
+    .JP9(JP9),
+    .CPU_SPEED_SWITCH(cpu_speed_switch),
+    .MAPROM_ENABLED(maprom_enabled),
+    .FLASH_BUSY_n(FLASH_BUSY_n),
+    .access(control_access),
+    .RW_n(RW_n),
+    .DS_n(ds_n),
+    .A(A[3:1]),
+    .data_in(D),
+    .data_out(control_data_out),
+    .CLKSEL(clksel),
+    .FLASH_ENABLE(flash_enable),
+    .FLASH_BASE(flash_base),
+    .MAPROM_OFF(maprom_off)
+);
+
+wire [15:0] ctrl_data_out = control_access    ? control_data_out    :
+                            perfmon_access    ? perfmon_data_out    :
+                            bustrace_access   ? bustrace_data_out   :
+                            waitstates_access ? waitstates_data_out :
+                                                16'd0;
+wire ctrl_data_oe = ctrl_access && RW_n && !ds_n;
+
+wire [15:0] data_out = ac_data_oe ? ac_data_out : ctrl_data_oe ? ctrl_data_out : sd_data_out;
+wire data_oe = ac_data_oe || sd_data_oe || ctrl_data_oe;
 assign D = data_oe ? data_out : 16'bz;
 
 endmodule
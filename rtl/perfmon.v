@@ -0,0 +1,196 @@
+`timescale 1ns / 1ps
+
+module perfmon(
+    input CLKCPU,
+    input RESET_n,
+    input AS_CPU_n,
+    input AS_MB_n,
+    input DTACK_CPU_n,
+    input [2:0] REGION,
+    input SD_XFER,
+    input SD_WORD,
+    input SD_UNDERRUN_T,
+    input access,
+    input RW_n,
+    input DS_n,
+    input [6:1] A,
+    input [15:0] data_in,
+    output reg [15:0] data_out
+);
+
+/*
+Performance counters, located at offset $1000 in the control board.
+
+Regions:
+0: Motherboard (Chip RAM, CIAs, custom chips, other expansions)
+1: Fast RAM
+2: Flash / MapROM
+3: IDE
+4: SD card
+5: Autoconfig and control board
+
+Registers (32 bit counters, high word first):
+$00 CTRL        bit 0: Freeze, bit 1: Clear (write only)
+$20 CLOCKS      CLKCPU cycles counted
+$24 MB_STALL    CLKCPU cycles waiting for AS_MB_n to be synced to C7M
+$28 SD_BYTES    Bytes moved through the SD data port
+$2C SD_UNDERRUN SD data port accesses the CPU buffers could not serve
+$40 + 4*n       Bus cycles in region n
+$60 + 4*n       CLKCPU cycles waiting for DTACK in region n
+
+Writing Freeze and Clear together clears all counters in the same clock and keeps them stopped.
+Counters are cleared and running after reset.
+*/
+
+localparam REG_CTRL        = 6'h00;
+localparam REG_CLOCKS      = 5'h08;
+localparam REG_MB_STALL    = 5'h09;
+localparam REG_SD_BYTES    = 5'h0A;
+localparam REG_SD_UNDERRUN = 5'h0B;
+
+localparam REGION_MB = 3'd0;
+
+reg freeze = 1'b0;
+reg clear = 1'b0;
+
+reg [31:0] clocks;
+reg [31:0] mb_stall;
+reg [31:0] sd_bytes;
+reg [31:0] sd_underrun;
+reg [31:0] bus_cycles [0:5];
+reg [31:0] wait_cycles [0:5];
+
+// Bus signals are registered once before they are counted, as they are asynchronous to CLKCPU during motherboard cycles.
+reg as_q = 1'b1;
+reg as_qq = 1'b1;
+reg as_mb_q = 1'b1;
+reg dtack_q = 1'b1;
+reg sd_xfer_q = 1'b0;
+reg sd_word_q = 1'b0;
+reg sd_seen = 1'b0;
+reg sd_seen_word = 1'b0;
+reg [2:0] region_q;
+reg [2:0] underrun_sync = 3'b000;
+
+wire cycle_start = !as_q && as_qq;
+wire cycle_end = as_q && !as_qq;
+wire waiting = !as_q && dtack_q;
+wire underrun = underrun_sync[2] != underrun_sync[1];
+
+integer i;
+
+always @(posedge CLKCPU) begin
+
+    as_q          <= AS_CPU_n;
+    as_qq         <= as_q;
+    as_mb_q       <= AS_MB_n;
+    dtack_q       <= DTACK_CPU_n;
+    sd_xfer_q     <= SD_XFER;
+    sd_word_q     <= SD_WORD;
+    region_q      <= REGION;
+    underrun_sync <= {underrun_sync[1:0], SD_UNDERRUN_T};
+
+    // Data strobes are late in write cycles, so SD transfers are remembered until the end of the cycle.
+    if (as_q) begin
+        sd_seen <= 1'b0;
+    end else if (sd_xfer_q) begin
+        sd_seen      <= 1'b1;
+        sd_seen_word <= sd_word_q;
+    end
+
+end
+
+always @(posedge CLKCPU) begin
+
+    if (!RESET_n) begin
+
+        freeze <= 1'b0;
+        clear  <= 1'b1;
+
+    end else begin
+
+        clear <= 1'b0;
+
+        if (access && !RW_n && !DS_n && A[6:1] == REG_CTRL) begin
+            freeze <= data_in[0];
+            clear  <= data_in[1];
+        end
+
+    end
+end
+
+always @(posedge CLKCPU) begin
+
+    if (clear) begin
+
+        clocks      <= 32'd0;
+        mb_stall    <= 32'd0;
+        sd_bytes    <= 32'd0;
+        sd_underrun <= 32'd0;
+
+        for (i = 0; i < 6; i = i + 1) begin
+            bus_cycles[i]  <= 32'd0;
+            wait_cycles[i] <= 32'd0;
+        end
+
+    end else if (!freeze) begin
+
+        clocks <= clocks + 1'b1;
+
+        if (cycle_start) begin
+            bus_cycles[region_q] <= bus_cycles[region_q] + 1'b1;
+        end
+
+        if (waiting) begin
+            wait_cycles[region_q] <= wait_cycles[region_q] + 1'b1;
+        end
+
+        if (waiting && as_mb_q && region_q == REGION_MB) begin
+            mb_stall <= mb_stall + 1'b1;
+        end
+
+        if (cycle_end && sd_seen) begin
+            sd_bytes <= sd_bytes + (sd_seen_word ? 2'd2 : 2'd1);
+        end
+
+        if (underrun) begin
+            sd_underrun <= sd_underrun + 1'b1;
+        end
+
+    end
+end
+
+// Register reads, A1 selects the high or low word of a counter.
+reg [31:0] rd_cnt;
+
+always @(*) begin
+
+    case (A[6:2])
+        REG_CLOCKS:      rd_cnt = clocks;
+        REG_MB_STALL:    rd_cnt = mb_stall;
+        REG_SD_BYTES:    rd_cnt = sd_bytes;
+        REG_SD_UNDERRUN: rd_cnt = sd_underrun;
+        5'h10:           rd_cnt = bus_cycles[0];
+        5'h11:           rd_cnt = bus_cycles[1];
+        5'h12:           rd_cnt = bus_cycles[2];
+        5'h13:           rd_cnt = bus_cycles[3];
+        5'h14:           rd_cnt = bus_cycles[4];
+        5'h15:           rd_cnt = bus_cycles[5];
+        5'h18:           rd_cnt = wait_cycles[0];
+        5'h19:           rd_cnt = wait_cycles[1];
+        5'h1A:           rd_cnt = wait_cycles[2];
+        5'h1B:           rd_cnt = wait_cycles[3];
+        5'h1C:           rd_cnt = wait_cycles[4];
+        5'h1D:           rd_cnt = wait_cycles[5];
+        default:         rd_cnt = 32'd0;
+    endcase
+
+    if (A[6:1] == REG_CTRL) begin
+        data_out = {15'd0, freeze};
+    end else begin
+        data_out = A[1] ? rd_cnt[15:0] : rd_cnt[31:16];
+    end
+
+end
+
+endmodule
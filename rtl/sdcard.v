@@ -14,6 +14,7 @@ module sdcard(
     input RW,
     input UDS_n,
     input LDS_n,
+    input [3:0] DELAY,
 
     output dtack_n,
     output reg ROM_OE_n,
@@ -23,6 +24,7 @@ module sdcard(
     output data_oe,
 
     output INT2_n,
+    output reg UNDERRUN_T,
 
     output SS_n,
     output SCLK,
@@ -66,8 +68,18 @@ always @(posedge CLKCPU or negedge RESET_n) begin
     end
 end
 
+// Optional wait states from the wait state table, counted in CLKCPU cycles
+reg [3:0] wait_cnt;
+
+always @(posedge CLKCPU) begin
+    if (!access)
+        wait_cnt <= 4'd0;
+    else if (wait_cnt != DELAY)
+        wait_cnt <= wait_cnt + 4'd1;
+end
+
 assign data_oe = rd_access;
-assign dtack_n = !access;
+assign dtack_n = !access || wait_cnt != DELAY;
 
 reg [2:0] reset_sync;
 reg reset_filtered;
@@ -330,6 +342,19 @@ wire [5:0] rx_len = rx_fifo_len + rx_cb_len;
 wire tx_atleast_half_empty = tx_len < 6'd16;
 wire rx_atleast_half_full = rx_len >= 6'd16;
 
+// Toggled when the CPU accesses the data port and the CPU buffer can't serve it,
+// i.e. reading more bytes than received or writing with no room left.
+wire rx_underrun = (rx_cb_rd_byte && rx_cb_empty) || (rx_cb_rd_word && !rx_cb_full);
+wire tx_overrun = (tx_cb_wr_byte && tx_cb_full) || (tx_cb_wr_word && !tx_cb_empty);
+
+always @(posedge C100M) begin
+    if (reset_filtered) begin
+        UNDERRUN_T <= 1'b0;
+    end else if (rx_underrun || tx_overrun) begin
+        UNDERRUN_T <= !UNDERRUN_T;
+    end
+end
+
 wire [15:0] status = {9'd0, shifter_busy, tx_atleast_half_empty, rx_atleast_half_full, tx_cb_full, tx_cb_empty, rx_cb_full, rx_cb_empty};
 
 // Latch data for CPU reads
@@ -0,0 +1,84 @@
+`timescale 1ns / 1ps
+
+module waitstates(
+    input CLKCPU,
+    input RESET_n,
+    input JP2,
+    input JP3,
+    input JP4,
+    input JP9,
+    input CPU_SPEED_SWITCH,
+    input access,
+    input RW_n,
+    input DS_n,
+    input [5:1] A,
+    input [15:0] data_in,
+    output reg [15:0] data_out,
+    output [3:0] RAM_DELAY,
+    output [3:0] FLASH_DELAY,
+    output [3:0] IDE_DELAY,
+    output [3:0] SD_DELAY
+);
+
+/*
+Wait state table, located at offset $3000 in the control board.
+
+One 32 bit entry per region, holding a nibble of wait states (CLKCPU cycles before DTACK)
+for each turbo speed, nibble n is used when {JP2, JP3, JP4} == n.
+No wait states are added at 7 MHz (SW1 closed).
+
+Registers:
+$00 RAM         Fast RAM                        Default $00000000
+$04 FLASH       Flash / MapROM                  Default $02200000, $03300000 with JP9 closed
+$08 IDE         IDE                             Default $02200000
+$0C SD          SD card                         Default $00000000
+
+The table is restored to the defaults on reset.
+*/
+
+localparam RAM_TABLE   = 3'd0;
+localparam FLASH_TABLE = 3'd1;
+localparam IDE_TABLE   = 3'd2;
+localparam SD_TABLE    = 3'd3;
+
+reg [31:0] ws_table [0:3];
+
+wire [2:0] clksel = {JP2, JP3, JP4};
+wire [4:0] nybble = {clksel, 2'b00};
+
+assign RAM_DELAY   = CPU_SPEED_SWITCH ? 4'd0 : ws_table[RAM_TABLE][nybble +: 4];
+assign FLASH_DELAY = CPU_SPEED_SWITCH ? 4'd0 : ws_table[FLASH_TABLE][nybble +: 4];
+assign IDE_DELAY   = CPU_SPEED_SWITCH ? 4'd0 : ws_table[IDE_TABLE][nybble +: 4];
+assign SD_DELAY    = CPU_SPEED_SWITCH ? 4'd0 : ws_table[SD_TABLE][nybble +: 4];
+
+always @(posedge CLKCPU) begin
+
+    if (!RESET_n) begin
+
+        ws_table[RAM_TABLE]   <= 32'h00000000;
+        ws_table[FLASH_TABLE] <= JP9 ? 32'h02200000 : 32'h03300000;
+        ws_table[IDE_TABLE]   <= 32'h02200000;
+        ws_table[SD_TABLE]    <= 32'h00000000;
+
+    end else if (access && !RW_n && !DS_n && !A[5] && !A[4]) begin
+
+        if (A[1]) begin
+            ws_table[A[3:2]][15:0] <= data_in;
+        end else begin
+            ws_table[A[3:2]][31:16] <= data_in;
+        end
+
+    end
+end
+
+always @(*) begin
+
+    if (!A[5] && !A[4]) begin
+        data_out = A[1] ? ws_table[A[3:2]][15:0] : ws_table[A[3:2]][31:16];
+    end else begin
+        data_out = 16'd0;
+    end
+
+end
+
+endmodule
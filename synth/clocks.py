@@ -0,0 +1,46 @@
+# Clock constraints for the open-source flow. C7M and C100M match sf2000.sdc,
+# CLKCPU is only constrained here, for the timing benchmark.
+#
+# Run by nextpnr with --pre-pack clocks.py, where it constrains every net that
+# clocks a flip-flop or block RAM. Also imported by report.py for the domain names.
+
+C7M_MHZ = 1000.0 / 141.044
+
+# (net name fragment, clock domain, MHz), the first match wins
+CLOCKS = [
+    ("CLKCPU",     "CLKCPU", C7M_MHZ * 7),     # C50M, the fastest PLL turbo setting
+    ("OSC_CLK_X1", "C100M",  100.0),
+    ("C100M",      "C100M",  100.0),
+    ("C7M",        "C7M",    C7M_MHZ),
+]
+
+CLOCK_PORTS = ("CLK", "CLKA", "CLKB")
+
+
+def domain(net):
+    for fragment, name, mhz in CLOCKS:
+        if fragment in net:
+            return name
+    return None
+
+
+def frequency(name):
+    for fragment, domain_name, mhz in CLOCKS:
+        if domain_name == name:
+            return mhz
+    return None
+
+
+if "ctx" in globals():
+    clock_nets = set()
+    for cell_name, cell in ctx.cells:
+        for port_name, port in cell.ports:
+            if port_name in CLOCK_PORTS and port.net is not None:
+                clock_nets.add(port.net.name)
+
+    for net in sorted(clock_nets):
+        name = domain(net)
+        if name is not None:
+            ctx.addClock(net, frequency(name))
+        else:
+            print("clocks.py: no constraint for clock net %s" % net)
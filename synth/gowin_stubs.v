@@ -0,0 +1,61 @@
+`timescale 1ns / 1ps
+
+/*
+Stand-ins for the Gowin IP wrappers, only used by the open-source flow in synth/.
+
+The clock outputs are passed straight through from their source so every clock net
+keeps its name in the netlist, the real frequencies are applied by clocks.py.
+Port lists match rtl/gowin_rpll_6x.v, rtl/gowin_rpll_14x.v, rtl/gowin_dcs.v
+and rtl/gowin_clkdiv_100M_to_28M.v.
+*/
+
+module Gowin_rPLL_6x (clkout, clkoutd, clkoutd3, reset, clkin);
+
+output clkout;
+output clkoutd;
+output clkoutd3;
+input reset;
+input clkin;
+
+assign clkout   = clkin;    // C42M
+assign clkoutd  = clkin;    // C21M
+assign clkoutd3 = clkin;    // C14M
+
+endmodule //Gowin_rPLL_6x
+
+module Gowin_rPLL_14x (clkout, clkoutd, clkoutd3, reset, clkin);
+
+output clkout;
+output clkoutd;
+output clkoutd3;
+input reset;
+input clkin;
+
+assign clkout   = clkin;    // C100M
+assign clkoutd  = clkin;    // C50M
+assign clkoutd3 = clkin;    // C33M
+
+endmodule //Gowin_rPLL_14x
+
+module Gowin_DCS (clkout, clksel, clk0, clk1, clk2, clk3);
+
+output clkout;
+input [3:0] clksel;
+input clk0;
+input clk1;
+input clk2;
+input clk3;
+
+assign clkout = clksel[0] & clk0 | clksel[1] & clk1 | clksel[2] & clk2 | clksel[3] & clk3;
+
+endmodule //Gowin_DCS
+
+module Gowin_CLKDIV_100M_to_28M (clkout, hclkin, resetn);
+
+output clkout;
+input hclkin;
+input resetn;
+
+assign clkout = hclkin;     // C28M
+
+endmodule //Gowin_CLKDIV_100M_to_28M
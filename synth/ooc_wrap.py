@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+#
+# Writes an out-of-context wrapper for one module, so it can be placed and routed
+# on its own without running out of pins.
+#
+# Clock ports stay top level ports. All other inputs are driven from a shift register
+# and all outputs are registered and XOR-ed into a single pin, which keeps every
+# register to register path inside the module while the I/O timing is left out.
+#
+# Usage: ooc_wrap.py <ports.json> <module>
+
+import json
+import sys
+
+import clocks
+
+# Clock used for the wrapper registers, in order of preference
+WRAPPER_CLOCKS = ("CLKCPU", "C7M", "C100M")
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit("Usage: ooc_wrap.py <ports.json> <module>")
+
+    with open(sys.argv[1]) as f:
+        netlist = json.load(f)
+
+    module = sys.argv[2]
+    ports = netlist["modules"][module]["ports"]
+
+    clock_ports = [name for name in ports if ports[name]["direction"] == "input" and clocks.domain(name) is not None]
+    inputs = [(name, len(p["bits"])) for name, p in ports.items() if p["direction"] == "input" and name not in clock_ports]
+    outputs = [(name, len(p["bits"])) for name, p in ports.items() if p["direction"] != "input"]
+
+    if not clock_ports:
+        sys.exit("ooc_wrap.py: %s has no clock input" % module)
+
+    wrapper_clock = clock_ports[0]
+    for name in WRAPPER_CLOCKS:
+        matches = [port for port in clock_ports if clocks.domain(port) == name]
+        if matches:
+            wrapper_clock = matches[0]
+            break
+
+    n_in = sum(width for name, width in inputs)
+    n_out = sum(width for name, width in outputs)
+
+    lines = []
+    lines.append("// Generated by ooc_wrap.py, out-of-context wrapper for %s" % module)
+    lines.append("")
+    lines.append("module %s_ooc(" % module)
+    for name in clock_ports:
+        lines.append("    input %s," % name)
+    lines.append("    input si,")
+    lines.append("    output so")
+    lines.append(");")
+    lines.append("")
+    if n_in:
+        lines.append("reg [%d:0] in_sr = %d'd0;" % (n_in - 1, n_in))
+    lines.append("wire [%d:0] out_w;" % (n_out - 1))
+    lines.append("reg [%d:0] out_r = %d'd0;" % (n_out - 1, n_out))
+    lines.append("")
+    lines.append("always @(posedge %s) begin" % wrapper_clock)
+    if n_in:
+        lines.append("    in_sr <= {in_sr, si};")
+    lines.append("    out_r <= out_w;")
+    lines.append("end")
+    lines.append("")
+    lines.append("assign so = ^out_r;")
+    lines.append("")
+
+    connections = ["    .%s(%s)" % (name, name) for name in clock_ports]
+    bit = 0
+    for name, width in inputs:
+        connections.append("    .%s(in_sr[%d:%d])" % (name, bit + width - 1, bit))
+        bit += width
+    bit = 0
+    for name, width in outputs:
+        connections.append("    .%s(out_w[%d:%d])" % (name, bit + width - 1, bit))
+        bit += width
+
+    lines.append("%s dut(" % module)
+    lines.append(",\n".join(connections))
+    lines.append(");")
+    lines.append("")
+    lines.append("endmodule")
+
+    print("\n".join(lines))
+
+
+if __name__ == "__main__":
+    main()
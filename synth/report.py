@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+#
+# Collects the Yosys and nextpnr results into one report, and compares a report
+# against the checked-in baseline.
+#
+# Usage: report.py collect <build dir> <top> <module>...
+#        report.py compare <baseline.json> <report.json> [<tolerance %>]
+#
+# Per module the report holds LUT/FF/BSRAM counts from Yosys and, per clock domain,
+# the achieved Fmax, the target and the worst slack (target period - achieved period)
+# from nextpnr. For the top module it also lists the clock domain crossings,
+# registers whose input logic starts at a register in another domain.
+#
+# compare fails for any result missing from the report or the baseline, so neither a
+# failed run nor a baseline that was never filled in by make baseline can pass.
+
+import json
+import os
+import sys
+
+import clocks
+
+BSRAM_TYPES = {"SP", "SPX9", "SDP", "SDPB", "SDPX9", "SDPX9B", "DP", "DPB", "DPX9", "DPX9B", "ROM", "pROM", "pROMX9"}
+
+
+def load(path):
+    if not os.path.exists(path):
+        return None
+    with open(path) as f:
+        return json.load(f)
+
+
+def is_sequential(cell_type):
+    return cell_type.startswith("DFF") or cell_type in BSRAM_TYPES
+
+
+def resources(stat):
+    if stat is None:
+        return {"luts": None, "ffs": None, "bsram": None}
+
+    if "design" in stat:
+        cells = stat["design"]["num_cells_by_type"]
+    else:
+        cells = next(iter(stat["modules"].values()))["num_cells_by_type"]
+
+    return {
+        "luts": sum(n for t, n in cells.items() if t.startswith("LUT") or t == "ALU"),
+        "ffs": sum(n for t, n in cells.items() if t.startswith("DFF")),
+        "bsram": sum(n for t, n in cells.items() if t in BSRAM_TYPES),
+    }
+
+
+def timing(pnr):
+    domains = {}
+    if pnr is None:
+        return domains
+
+    for net, fmax in pnr.get("fmax", {}).items():
+        name = clocks.domain(net) or net
+        slack = 1000.0 / fmax["constraint"] - 1000.0 / fmax["achieved"]
+        if name not in domains or slack < domains[name]["slack_ns"]:
+            domains[name] = {
+                "fmax_mhz": round(fmax["achieved"], 2),
+                "target_mhz": round(fmax["constraint"], 2),
+                "slack_ns": round(slack, 3),
+            }
+
+    return domains
+
+
+def bit_names(module):
+    names = {}
+    for name, net in module["netnames"].items():
+        if net.get("hide_name"):
+            continue
+        for i, bit in enumerate(net["bits"]):
+            if not isinstance(bit, int):
+                continue
+            label = name if len(net["bits"]) == 1 else "%s[%d]" % (name, i)
+            if bit not in names or len(label) < len(names[bit]):
+                names[bit] = label
+    return names
+
+
+def port_clock(cell, port):
+    connections = cell["connections"]
+    if "CLK" in connections:
+        return connections["CLK"][0]
+    side = "A" if port == "DI" or port.endswith("A") else "B"
+    return connections.get("CLK" + side, [None])[0]
+
+
+def crossings(netlist, top):
+    module = netlist["modules"][top]
+    cells = module["cells"]
+    names = bit_names(module)
+
+    drivers = {}
+    for cell_name, cell in cells.items():
+        for port, direction in cell["port_directions"].items():
+            if direction == "output":
+                for bit in cell["connections"][port]:
+                    drivers[bit] = (cell_name, port)
+
+    memo = {}
+
+    def sources(bit):
+        # Clock bits of the registers that the logic driving this bit starts at
+        if not isinstance(bit, int):
+            return frozenset()
+        if bit in memo:
+            return memo[bit]
+        memo[bit] = frozenset()     # Breaks combinational loops
+
+        result = frozenset()
+        if bit in drivers:
+            cell_name, port = drivers[bit]
+            cell = cells[cell_name]
+            if is_sequential(cell["type"]):
+                clock = port_clock(cell, port)
+                result = frozenset([clock]) if isinstance(clock, int) else frozenset()
+            else:
+                for p, direction in cell["port_directions"].items():
+                    if direction == "input":
+                        for b in cell["connections"][p]:
+                            result |= sources(b)
+
+        memo[bit] = result
+        return result
+
+    def clock_domain(bit):
+        name = names.get(bit, str(bit))
+        return clocks.domain(name) or name
+
+    found = {}
+    for cell_name, cell in cells.items():
+        if not is_sequential(cell["type"]):
+            continue
+
+        outputs = [b for p, d in cell["port_directions"].items() if d == "output" for b in cell["connections"][p]]
+        register = names.get(outputs[0], cell_name) if outputs else cell_name
+        register = register.split("[")[0]
+
+        for port, direction in cell["port_directions"].items():
+            if direction != "input" or port in clocks.CLOCK_PORTS:
+                continue
+            sink = port_clock(cell, port)
+            if not isinstance(sink, int):
+                continue
+            for bit in cell["connections"][port]:
+                for source in sources(bit):
+                    if clock_domain(source) != clock_domain(sink):
+                        pair = "%s->%s" % (clock_domain(source), clock_domain(sink))
+                        found.setdefault(pair, set()).add(register)
+
+    return {pair: sorted(registers) for pair, registers in sorted(found.items())}
+
+
+def collect(build, top, modules):
+    report = {"top": top, "modules": {}}
+
+    for module in [top] + modules:
+        entry = resources(load(os.path.join(build, module + ".stat.json")))
+        entry["clocks"] = timing(load(os.path.join(build, module + ".pnr.json")))
+        if module == top:
+            netlist = load(os.path.join(build, module + ".syn.json"))
+            entry["cdc"] = crossings(netlist, top) if netlist else None
+        report["modules"][module] = entry
+
+    json.dump(report, sys.stdout, indent=2, sort_keys=True)
+    print()
+
+
+def incomplete(report, top):
+    # Items the flow produced no result for, a synthesis or place and route step failed
+    result = []
+    for module, entry in sorted(report.items()):
+        for item in ("luts", "ffs", "bsram"):
+            if entry.get(item) is None:
+                result.append("%s %s" % (module, item))
+        if not entry.get("clocks"):
+            result.append("%s clocks" % module)
+        if module == top and entry.get("cdc") is None:
+            result.append("%s cdc" % module)
+    return result
+
+
+def missing(baseline, report):
+    # Items the report has results for but the baseline doesn't, these can't be checked
+    result = []
+    for module, entry in sorted(report.items()):
+        base = baseline.get(module) or {}
+        for item in ("luts", "ffs", "bsram"):
+            if entry[item] is not None and base.get(item) is None:
+                result.append("%s %s" % (module, item))
+        for name in sorted(entry["clocks"]):
+            if name not in (base.get("clocks") or {}):
+                result.append("%s %s" % (module, name))
+        if entry.get("cdc") is not None and base.get("cdc") is None:
+            result.append("%s cdc" % module)
+    return result
+
+
+def compare(baseline_path, report_path, tolerance):
+    baseline = load(baseline_path)["modules"]
+    current = load(report_path)
+    report = current["modules"]
+    failed = False
+
+    empty = incomplete(report, current.get("top"))
+    if empty:
+        print("FAIL: %s has no results for %s" % (report_path, ", ".join(empty)))
+        print()
+        failed = True
+
+    unchecked = missing(baseline, report)
+    if unchecked:
+        print("FAIL: %s has no results for %s" % (baseline_path, ", ".join(unchecked)))
+        print("Run make baseline on a known good tree and check the baseline in.")
+        print()
+        failed = True
+
+    print("%-16s %-8s %10s %10s %10s" % ("Module", "Item", "Baseline", "Current", "Change"))
+
+    for module, entry in sorted(report.items()):
+        base = baseline.get(module, {})
+
+        for item in ("luts", "ffs", "bsram"):
+            old, new = base.get(item), entry[item]
+            change = "" if old is None or new is None else "%+d" % (new - old)
+            print("%-16s %-8s %10s %10s %10s" % (module, item, old, new, change))
+
+        for name, now in sorted(entry["clocks"].items()):
+            was = base.get("clocks", {}).get(name)
+            old = was["fmax_mhz"] if was else None
+            change = "" if old is None else "%+.1f%%" % (100.0 * (now["fmax_mhz"] - old) / old)
+            note = ""
+            if now["slack_ns"] < 0 and (was is None or was["slack_ns"] >= 0):
+                note = "  FAIL: misses %.2f MHz" % now["target_mhz"]
+                failed = True
+            elif old is not None and now["fmax_mhz"] < old * (1 - tolerance / 100.0):
+                note = "  FAIL: Fmax dropped"
+                failed = True
+            print("%-16s %-8s %10s %10.2f %10s%s" % (module, name, old, now["fmax_mhz"], change, note))
+
+        if entry.get("cdc") is not None:
+            old_cdc = base.get("cdc") or {}
+            for pair, registers in sorted(entry["cdc"].items()):
+                added = sorted(set(registers) - set(old_cdc.get(pair, [])))
+                print("%-16s %-8s %10s %10d" % (module, "cdc", len(old_cdc.get(pair, [])), len(registers)) + "  " + pair)
+                for register in added:
+                    print("%-16s          new crossing into %s" % ("", register))
+                    failed = True
+
+    return 1 if failed else 0
+
+
+def main():
+    if len(sys.argv) >= 4 and sys.argv[1] == "collect":
+        collect(sys.argv[2], sys.argv[3], sys.argv[4:])
+    elif len(sys.argv) in (4, 5) and sys.argv[1] == "compare":
+        tolerance = float(sys.argv[4]) if len(sys.argv) == 5 else 5.0
+        sys.exit(compare(sys.argv[2], sys.argv[3], tolerance))
+    else:
+        sys.exit("Usage: report.py collect <build dir> <top> <module>...\n"
+                 "       report.py compare <baseline.json> <report.json> [<tolerance %>]")
+
+
+if __name__ == "__main__":
+    main()